@@ -0,0 +1,363 @@
+#!/usr/bin/env python3
+###
+# @file
+# Turns a binary UefiSeven log (UefiSeven.blog, written with logfile=2) back
+# into the text that logfile=1 would have produced.
+#
+# Records only hold offsets of the format string and function name within
+# the UefiSeven image, so the exact .efi file that wrote the log is needed:
+#
+#   BlogDecode.py Build/.../UefiSeven.efi UefiSeven.blog [-t]
+#
+# A memory dump of the published log table (logtable=1 or 2) works in
+# place of either log file.
+#
+# Both log files are circular, several boots long. Text logs are just put
+# back in chronological order:
+#
+#   BlogDecode.py UefiSeven.log
+#
+# Copyright (c) 2020, Seungjoo Kim
+#
+# This program and the accompanying materials are licensed and made available
+# under the terms and conditions of the BSD License which accompanies this
+# distribution.  The full text of the license may be found at
+# http://opensource.org/licenses/bsd-license.php
+#
+# THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS, WITHOUT
+# WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+#
+###
+
+import argparse
+import struct
+import sys
+import uuid
+
+# Must match Log.h.
+BLOG_SIGNATURE        = b'U7BLOG\0\0'
+BLOG_VERSION          = 1
+BLOG_HEADER           = struct.Struct('<8sIIQ')
+BLOG_RECORD           = struct.Struct('<HBBIIQ')
+BLOG_TYPE_DEBUG       = 0
+BLOG_TYPE_ERROR       = 1
+BLOG_TYPE_CALIBRATION = 2
+BLOG_FLAG_TRUNCATED   = 0x80
+LOG_FILE_SIGNATURE    = b'U7LF'
+LOG_FILE_VERSION      = 1
+LOG_FILE_HEADER       = struct.Struct('<4sIIIIIB7x')
+LOG_TABLE_SIGNATURE   = b'U7LT'
+LOG_TABLE_HEADER      = struct.Struct('<4sIII')
+LOG_TABLE_RING        = struct.Struct('<QII')  # last fields of LOG_TABLE
+
+# MdePkg BasePrintLib mStatusString.
+EFI_ERRORS = [
+    'Success', 'Load Error', 'Invalid Parameter', 'Unsupported', 'Bad Buffer Size',
+    'Buffer Too Small', 'Not Ready', 'Device Error', 'Write Protected', 'Out of Resources',
+    'Volume Corrupt', 'Volume Full', 'No Media', 'Media changed', 'Not Found',
+    'Access Denied', 'No Response', 'No mapping', 'Time out', 'Not started',
+    'Already started', 'Aborted', 'ICMP Error', 'TFTP Error', 'Protocol Error',
+    'Incompatible Version', 'Security Violation', 'CRC Error', 'End of Media', 'Reserved (29)',
+    'Reserved (30)', 'End of File', 'Invalid Language', 'Compromised Data', 'IP Address Conflict',
+    'HTTP Error'
+]
+EFI_WARNINGS = [
+    'Success', 'Warning Unknown Glyph', 'Warning Delete Failure', 'Warning Write Failure',
+    'Warning Buffer Too Small', 'Warning Stale Data', 'Warning File System', 'Warning Reset Required'
+]
+
+
+class Image:
+    """Reads strings out of a PE/COFF image by their RVA."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:2] != b'MZ':
+            raise ValueError('%s is not a PE image' % path)
+        pe = struct.unpack_from('<I', self.data, 0x3C)[0]
+        if self.data[pe:pe + 4] != b'PE\0\0':
+            raise ValueError('%s is not a PE image' % path)
+        sections, optsize = struct.unpack_from('<2xH12xH', self.data, pe + 4)
+        offset = pe + 24 + optsize
+        self.sections = []
+        for i in range(sections):
+            vsize, va, rawsize, rawptr = struct.unpack_from('<8xIIII', self.data, offset + i * 40)
+            self.sections.append((va, max(vsize, rawsize), rawptr, rawsize))
+
+    def offset(self, rva):
+        for va, size, rawptr, rawsize in self.sections:
+            if va <= rva < va + size and rva - va < rawsize:
+                return rawptr + rva - va
+        raise KeyError('RVA %#x not in image' % rva)
+
+    def ascii(self, rva):
+        start = self.offset(rva)
+        end = self.data.index(b'\0', start)
+        return self.data[start:end].decode('ascii', 'replace')
+
+    def unicode(self, rva):
+        start = end = self.offset(rva)
+        while self.data[end:end + 2] != b'\0\0':
+            end += 2
+        return self.data[start:end].decode('utf-16-le', 'replace')
+
+
+class Args:
+    """Pulls raw arguments out of a record, in the order LogAppendBinary wrote them."""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def number(self):
+        if self.pos + 8 > len(self.data):
+            return None
+        value = struct.unpack_from('<Q', self.data, self.pos)[0]
+        self.pos += 8
+        return value
+
+    def string(self):
+        if self.pos + 2 > len(self.data):
+            return None
+        length = struct.unpack_from('<H', self.data, self.pos)[0]
+        value = self.data[self.pos + 2:self.pos + 2 + length].decode('ascii', 'replace')
+        self.pos += 2 + length
+        return value
+
+    def blob16(self):
+        if self.pos + 17 > len(self.data):
+            return None
+        present = self.data[self.pos]
+        value = self.data[self.pos + 1:self.pos + 17]
+        self.pos += 17
+        return value if present else b''
+
+
+def status_string(value):
+    if value & (1 << 63):
+        code = value & ~(1 << 63)
+        if code < len(EFI_ERRORS):
+            return EFI_ERRORS[code]
+    elif value < len(EFI_WARNINGS):
+        return EFI_WARNINGS[value]
+    return '%X' % value
+
+
+def pad(text, width, left, zero):
+    if width is None or len(text) >= width:
+        return text
+    if left:
+        return text.ljust(width)
+    if zero and text[:1] == '-':
+        return '-' + text[1:].rjust(width - 1, '0')
+    return text.rjust(width, '0' if zero else ' ')
+
+
+def format_message(fmt, args):
+    """A subset of BasePrintLib formatting, covering what UefiSeven uses."""
+    out = []
+    i = 0
+    while i < len(fmt):
+        c = fmt[i]
+        i += 1
+        if c != '%':
+            out.append(c)
+            continue
+        left = zero = plus = space = comma = is_long = False
+        width = precision = None
+        while i < len(fmt):
+            c = fmt[i]
+            if c == '-':
+                left = True
+            elif c == '+':
+                plus = True
+            elif c == ' ':
+                space = True
+            elif c == ',':
+                comma = True
+            elif c == '0' and width is None and precision is None:
+                zero = True
+            elif c.isdigit():
+                if precision is not None:
+                    precision = precision * 10 + int(c)
+                else:
+                    width = (width or 0) * 10 + int(c)
+            elif c == '.':
+                precision = 0
+            elif c == '*':
+                value = args.number()
+                if precision is not None:
+                    precision = value
+                else:
+                    width = value
+            elif c in 'lL':
+                is_long = True
+            else:
+                break
+            i += 1
+        if i >= len(fmt):
+            break
+        c = fmt[i]
+        i += 1
+
+        if c in 'dxXu':
+            value = args.number()
+            if value is None:
+                out.append('?')
+                continue
+            if not is_long:
+                value &= 0xFFFFFFFF
+                if c == 'd' and value & 0x80000000:
+                    value -= 1 << 32
+            elif c == 'd' and value & (1 << 63):
+                value -= 1 << 64
+            if c == 'x':
+                text = '%x' % value
+            elif c == 'X':
+                text = '%X' % value
+            else:
+                text = '{:,}'.format(value) if comma else '%d' % value
+                if value >= 0 and (plus or space):
+                    text = ('+' if plus else ' ') + text
+            out.append(pad(text, width, left, zero))
+        elif c == 'p':
+            value = args.number()
+            out.append('?' if value is None else '%016X' % value)
+        elif c == 'c':
+            value = args.number()
+            out.append('?' if value is None else pad(chr(value & 0xFFFF), width, left, False))
+        elif c == 'r':
+            value = args.number()
+            out.append('?' if value is None else pad(status_string(value), width, left, False))
+        elif c in 'sSa':
+            value = args.string()
+            if value is None:
+                out.append('?')
+                continue
+            if precision is not None:
+                value = value[:precision]
+            out.append(pad(value, width, left, False))
+        elif c == 'g':
+            value = args.blob16()
+            if value is None:
+                out.append('?')
+            else:
+                out.append(str(uuid.UUID(bytes_le=value)) if value else '<null guid>')
+        elif c == 't':
+            value = args.blob16()
+            if value is None:
+                out.append('?')
+            elif not value:
+                out.append('<null time>')
+            else:
+                year, month, day, hour, minute = struct.unpack_from('<HBBBB', value)
+                out.append('%02d/%02d/%04d  %02d:%02d' % (month, day, year, hour, minute))
+        elif c == '%':
+            out.append('%')
+        else:
+            out.append('%' + c)
+    return ''.join(out)
+
+
+def decode(image, blog, timestamps):
+    if len(blog) < BLOG_HEADER.size:
+        raise ValueError('log too short')
+    signature, version, header_size, image_base = BLOG_HEADER.unpack_from(blog)
+    if signature != BLOG_SIGNATURE or version != BLOG_VERSION:
+        raise ValueError('not a UefiSeven binary log (or unsupported version)')
+
+    # Timestamps need the calibration record, which is near the end.
+    ticks_per_us = None
+    records = []
+    pos = header_size
+    while pos + BLOG_RECORD.size <= len(blog):
+        size, rtype, _, format_rva, func_rva, tsc = BLOG_RECORD.unpack_from(blog, pos)
+        if size < BLOG_RECORD.size or pos + size > len(blog):
+            break
+        args = Args(blog[pos + BLOG_RECORD.size:pos + size])
+        if rtype & ~BLOG_FLAG_TRUNCATED == BLOG_TYPE_CALIBRATION:
+            ticks, us = args.number(), args.number()
+            if ticks and us:
+                ticks_per_us = ticks / us
+        else:
+            records.append((rtype, format_rva, func_rva, tsc, args))
+        pos += size
+
+    lines = []
+    first_tsc = records[0][3] if records else 0
+    for rtype, format_rva, func_rva, tsc, args in records:
+        try:
+            text = '%s: %s' % (image.ascii(func_rva), format_message(image.unicode(format_rva), args))
+        except (KeyError, ValueError) as e:
+            text = '<undecodable record: %s>\n' % e
+        if rtype & BLOG_FLAG_TRUNCATED:
+            text = text.rstrip('\n') + ' [truncated]\n'
+        if timestamps:
+            if ticks_per_us:
+                text = '[%10.3f ms] %s' % ((tsc - first_tsc) / ticks_per_us / 1000, text)
+            else:
+                text = '[%14d] %s' % (tsc - first_tsc, text)
+        lines.append(text)
+    return ''.join(lines)
+
+
+def unwrap(log):
+    """Returns the log data of a circular log file in chronological order,
+    and whether its oldest part has already been overwritten."""
+    if len(log) >= LOG_TABLE_HEADER.size and log[:4] == LOG_TABLE_SIGNATURE:
+        header_size = LOG_TABLE_HEADER.unpack_from(log)[2]
+        head, offset, size = LOG_TABLE_RING.unpack_from(log, header_size - LOG_TABLE_RING.size)
+        data = log[offset:offset + size]
+        if head <= size:
+            return data[:head], False
+        return data[head % size:] + data[:head % size], True
+    if len(log) < LOG_FILE_HEADER.size or log[:4] != LOG_FILE_SIGNATURE:
+        return log, False
+    _, version, data_offset, data_size, write_offset, boots, wrapped = LOG_FILE_HEADER.unpack_from(log)
+    if version != LOG_FILE_VERSION:
+        raise ValueError('unsupported log file version %d' % version)
+    data = log[data_offset:data_offset + data_size]
+    if not wrapped:
+        return data[:write_offset], False
+    return data[write_offset:] + data[:write_offset], True
+
+
+def decode_all(image, log, timestamps):
+    """Decodes every boot found in the log. The oldest one may have
+    been partially overwritten and is skipped up to its first intact
+    binary header."""
+    boots = log.split(BLOG_SIGNATURE)[1:]
+    if not boots:
+        raise ValueError('no UefiSeven binary log header found')
+    return ''.join(decode(image, BLOG_SIGNATURE + boot, timestamps) for boot in boots)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a UefiSeven log file.')
+    parser.add_argument('files', nargs='+', metavar='[IMAGE] LOG',
+                        help='UefiSeven .efi image that wrote a binary log, followed by the log file; '
+                             'text logs need no image')
+    parser.add_argument('-t', '--timestamps', action='store_true',
+                        help='prefix binary log lines with the time since the first record of the boot')
+    options = parser.parse_args()
+    if len(options.files) > 2:
+        parser.error('expected at most an image and a log file')
+
+    with open(options.files[-1], 'rb') as f:
+        log = f.read()
+    try:
+        log, wrapped = unwrap(log)
+        if len(options.files) == 2:
+            sys.stdout.write(decode_all(Image(options.files[0]), log, options.timestamps))
+        else:
+            if wrapped:
+                # The oldest line has most likely been cut.
+                log = log[log.find(b'\n') + 1:]
+            sys.stdout.write(log.decode('ascii', 'replace'))
+    except ValueError as e:
+        sys.exit('%s: %s' % (options.files[-1], e))
+
+
+if __name__ == '__main__':
+    main()
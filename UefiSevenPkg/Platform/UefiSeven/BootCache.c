@@ -0,0 +1,217 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "BootCache.h"
+#include "Display.h"
+#include "Filesystem.h"
+#include "Util.h"
+
+
+/**
+  -----------------------------------------------------------------------------
+  Variables.
+  -----------------------------------------------------------------------------
+**/
+
+BOOT_CACHE          mBootCache;
+BOOLEAN             mBootCacheLoaded    = FALSE;
+
+STATIC BOOLEAN      mFingerprintValid     = FALSE;
+STATIC BOOT_CACHE   mStoredBootCache;
+STATIC BOOLEAN      mStoredBootCacheValid = FALSE;
+
+
+/**
+  -----------------------------------------------------------------------------
+  Local method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Computes a checksum over everything the cached decisions depend
+  on: the GOP mode list with what QueryMode reported for every
+  mode, the framebuffer, the EDID of the display and the config file.
+  Only in-memory information is used, the config file is looked
+  up in the directory cache.
+
+  @param[in] ConfigFilePath Path to the config file.
+  @param[out] Fingerprint   The resulting checksum.
+
+  @retval EFI_SUCCESS       The fingerprint was computed.
+  @retval other             Not enough information is available,
+                            the cache cannot be used.
+
+**/
+EFI_STATUS
+ComputeBootCacheFingerprint (
+  IN  CHAR16  *ConfigFilePath,
+  OUT UINT32  *Fingerprint
+  )
+{
+  BOOT_CACHE_FINGERPRINT      Data;
+  BOOT_CACHE_FINGERPRINT_MODE ModeData;
+  CONST EFI_FILE_INFO         *FileInfo;
+  UINT32                      Index;
+
+  if (EFI_ERROR (EnsureDisplayAvailable ()) || (mDisplayInfo.Protocol != GOP) || (mDisplayInfo.Modes == NULL)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!GetCachedFileInfo (ConfigFilePath, &FileInfo)) {
+    return EFI_NOT_FOUND;
+  }
+
+  ZeroMem (&Data, sizeof (Data));
+  Data.MaxMode          = mDisplayInfo.GOP->Mode->MaxMode;
+  Data.FrameBufferBase  = mDisplayInfo.GOP->Mode->FrameBufferBase;
+
+  // The mode table already holds the QueryMode results, chain them.
+  for (Index = 0; Index < mDisplayInfo.ModeCount; Index++) {
+    ModeData.PreviousCrc          = Data.ModesCrc;
+    ModeData.Valid                = mDisplayInfo.Modes[Index].Valid;
+    ModeData.HorizontalResolution = mDisplayInfo.Modes[Index].HorizontalResolution;
+    ModeData.VerticalResolution   = mDisplayInfo.Modes[Index].VerticalResolution;
+    ModeData.PixelFormat          = (UINT32)mDisplayInfo.Modes[Index].PixelFormat;
+    ModeData.PixelsPerScanLine    = mDisplayInfo.Modes[Index].PixelsPerScanLine;
+    gBS->CalculateCrc32 (&ModeData, sizeof (ModeData), &Data.ModesCrc);
+  }
+
+  if (mDisplayInfo.Edid != NULL) {
+    gBS->CalculateCrc32 (mDisplayInfo.Edid, mDisplayInfo.EdidSize, &Data.EdidCrc);
+  }
+  if (FileInfo != NULL) {
+    Data.ConfigFileSize = FileInfo->FileSize;
+    CopyMem (&Data.ConfigModificationTime, &FileInfo->ModificationTime, sizeof (EFI_TIME));
+  }
+
+  return gBS->CalculateCrc32 (&Data, sizeof (Data), Fingerprint);
+}
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Prepares mBootCache for the current boot and, if the NV variable
+  written during a previous boot is still valid for the current
+  hardware and config, fills it with the decisions made back then.
+
+  @param[in] ConfigFilePath Path to the config file.
+
+  @retval TRUE            Cached decisions were loaded into mBootCache.
+  @retval FALSE           Nothing usable was cached, mBootCache only
+                          holds defaults.
+
+**/
+BOOLEAN
+LoadBootCache (
+  IN  CHAR16  *ConfigFilePath
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Fingerprint;
+  UINTN       DataSize;
+
+  ZeroMem (&mBootCache, sizeof (BOOT_CACHE));
+  mBootCache.Signature  = BOOT_CACHE_SIGNATURE;
+  mBootCache.Revision   = BOOT_CACHE_REVISION;
+  mBootCache.Size       = (UINT16)sizeof (BOOT_CACHE);
+  mBootCache.GopMode    = BOOT_CACHE_NO_MODE;
+  mBootCacheLoaded      = FALSE;
+
+  Status = ComputeBootCacheFingerprint (ConfigFilePath, &Fingerprint);
+  if (EFI_ERROR (Status)) {
+    PrintDebug (L"Boot cache disabled, unable to fingerprint this boot (error: %r)\n", Status);
+    return FALSE;
+  }
+  mBootCache.Fingerprint = Fingerprint;
+  mFingerprintValid      = TRUE;
+
+  DataSize = sizeof (BOOT_CACHE);
+  Status = gRT->GetVariable (
+                  BOOT_CACHE_VARIABLE_NAME,
+                  &gUefiSevenBootCacheGuid,
+                  NULL,
+                  &DataSize,
+                  &mStoredBootCache);
+  mStoredBootCacheValid = !EFI_ERROR (Status)
+    && (DataSize == sizeof (BOOT_CACHE))
+    && (mStoredBootCache.Signature == BOOT_CACHE_SIGNATURE)
+    && (mStoredBootCache.Revision == BOOT_CACHE_REVISION)
+    && (mStoredBootCache.Size == sizeof (BOOT_CACHE));
+
+  if (!mStoredBootCacheValid) {
+    PrintDebug (L"No usable boot cache found (status: %r)\n", Status);
+    return FALSE;
+  }
+
+  if (mStoredBootCache.Fingerprint != Fingerprint) {
+    PrintDebug (L"Boot cache fingerprint changed (%08x != %08x), ignoring it\n",
+      mStoredBootCache.Fingerprint, Fingerprint);
+    return FALSE;
+  }
+
+  CopyMem (&mBootCache, &mStoredBootCache, sizeof (BOOT_CACHE));
+  mBootCacheLoaded = TRUE;
+
+  PrintDebug (L"Boot cache loaded: mode=%d hack=%d unlock=%u lock=%u lowmem=%d config=%d\n",
+    (INT32)mBootCache.GopMode, mBootCache.ScanlineHack,
+    mBootCache.UnlockMethod, mBootCache.LockMethod, mBootCache.LowMemoryShim, mBootCache.ConfigValid);
+
+  return TRUE;
+}
+
+
+/**
+  Stores the decisions made during the current boot in the NV
+  variable. The variable is only written when something differs
+  from what is already stored, so warm boots do not wear flash.
+
+**/
+VOID
+SaveBootCache (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  if (!mFingerprintValid) {
+    return;
+  }
+
+  if (mStoredBootCacheValid && (CompareMem (&mStoredBootCache, &mBootCache, sizeof (BOOT_CACHE)) == 0)) {
+    PrintDebug (L"Boot cache up to date\n");
+    return;
+  }
+
+  Status = gRT->SetVariable (
+                  BOOT_CACHE_VARIABLE_NAME,
+                  &gUefiSevenBootCacheGuid,
+                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                  sizeof (BOOT_CACHE),
+                  &mBootCache);
+  if (EFI_ERROR (Status)) {
+    PrintDebug (L"Unable to save boot cache (error: %r)\n", Status);
+    return;
+  }
+
+  CopyMem (&mStoredBootCache, &mBootCache, sizeof (BOOT_CACHE));
+  mStoredBootCacheValid = TRUE;
+  PrintDebug (L"Boot cache saved\n");
+}
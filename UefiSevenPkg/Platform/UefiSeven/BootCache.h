@@ -0,0 +1,139 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __BOOT_CACHE_H
+#define __BOOT_CACHE_H
+
+
+/**
+  -----------------------------------------------------------------------------
+  Constants.
+  -----------------------------------------------------------------------------
+**/
+
+#define BOOT_CACHE_VARIABLE_NAME    L"UefiSevenBootCache"
+#define BOOT_CACHE_SIGNATURE        SIGNATURE_32 ('U', '7', 'B', 'C')
+#define BOOT_CACHE_REVISION         14
+#define BOOT_CACHE_NO_MODE          MAX_UINT32
+
+
+
+/**
+  -----------------------------------------------------------------------------
+  Includes.
+  -----------------------------------------------------------------------------
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+
+/**
+  -----------------------------------------------------------------------------
+  Type definitions and enums.
+  -----------------------------------------------------------------------------
+**/
+
+//
+// What QueryMode reported for one GOP mode, as fed into the fingerprint.
+//
+#pragma pack(1)
+typedef struct {
+  UINT32                  PreviousCrc;
+  UINT32                  Valid;
+  UINT32                  HorizontalResolution;
+  UINT32                  VerticalResolution;
+  UINT32                  PixelFormat;
+  UINT32                  PixelsPerScanLine;
+} BOOT_CACHE_FINGERPRINT_MODE;
+
+//
+// Whatever the cached decisions depend on. If any of it changes,
+// the cache is ignored and rebuilt.
+//
+typedef struct {
+  UINT32                  MaxMode;
+  UINT32                  ModesCrc;           // chained over BOOT_CACHE_FINGERPRINT_MODE
+  EFI_PHYSICAL_ADDRESS    FrameBufferBase;
+  UINT32                  EdidCrc;            // 0 without EDID
+  UINT64                  ConfigFileSize;
+  EFI_TIME                ConfigModificationTime;
+} BOOT_CACHE_FINGERPRINT;
+
+typedef struct {
+  UINT32    Signature;
+  UINT16    Revision;
+  UINT16    Size;
+  UINT32    Fingerprint;            // CRC32 of BOOT_CACHE_FINGERPRINT
+
+  // Video.
+  UINT32    GopMode;                // chosen mode number or BOOT_CACHE_NO_MODE
+  BOOLEAN   ScanlineHack;           // ForceVideoModeHack was needed
+
+  // VGA ROM memory locking, MEMORY_LOCK_METHOD values.
+  UINT8     UnlockMethod;
+  UINT8     LockMethod;
+  BOOLEAN   LowMemoryShim;          // no way to unlock the VGA ROM, shim placed below 640 KiB
+
+  // Config parsed from the INI file.
+  BOOLEAN   ConfigValid;
+  BOOLEAN   SkipErrors;
+  BOOLEAN   ForceFakeVesa;
+  BOOLEAN   FbWriteCombine;
+  BOOLEAN   NativeRes;
+  BOOLEAN   HandlerTrace;           // instrumented Int10h handler
+  UINT16    HandlerPort;            // 0 = not configured
+  UINT32    HandlerBaud;            // 0 = not configured
+  BOOLEAN   VerboseMode;
+  BOOLEAN   LogToFile;
+  BOOLEAN   LogToTable;
+  BOOLEAN   BinaryLog;
+  BOOLEAN   BinaryTable;
+  UINT8     LogLevel;
+} BOOT_CACHE;
+#pragma pack()
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method signatures.
+  -----------------------------------------------------------------------------
+**/
+
+BOOLEAN
+LoadBootCache (
+  IN  CHAR16  *ConfigFilePath
+  );
+
+VOID
+SaveBootCache (
+  VOID
+  );
+
+
+/**
+  -----------------------------------------------------------------------------
+  Imported global variables.
+  -----------------------------------------------------------------------------
+**/
+
+extern BOOT_CACHE   mBootCache;
+extern BOOLEAN      mBootCacheLoaded;
+
+
+#endif
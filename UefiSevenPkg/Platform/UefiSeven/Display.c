@@ -24,6 +24,183 @@
 **/
 
 
+/**
+  Returns the mode table bucket for a resolution.
+
+  @param[in] Width      Screen width.
+  @param[in] Height     Screen height.
+
+  @retval UINT32        Index into mDisplayInfo.ModeBuckets.
+
+**/
+UINT32
+DisplayModeBucket (
+  IN UINTN    Width,
+  IN UINTN    Height
+  )
+{
+  return (UINT32)((Width * 31 + Height) & (DISPLAY_MODE_BUCKETS - 1));
+}
+
+
+/**
+  Queries every GOP mode once and keeps what is needed for mode
+  decisions in mDisplayInfo.Modes, so that the firmware (which can
+  be slow with many modes) is not asked again. Modes that fail to
+  be queried are kept as invalid entries.
+
+  @retval EFI_SUCCESS     The mode table has been built.
+  @retval other           The mode table could not be allocated.
+
+**/
+EFI_STATUS
+BuildModeTable (
+  VOID
+  )
+{
+  EFI_STATUS                              Status;
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION    *ModeInfo;
+  DISPLAY_MODE                            *Mode;
+  UINTN                                   SizeOfInfo;
+  UINT32                                  Bucket;
+  UINT32                                  BitsPerPixel;
+  UINT32                                  i;
+
+  SetMem32 (mDisplayInfo.ModeBuckets, sizeof (mDisplayInfo.ModeBuckets), DISPLAY_MODE_NONE);
+  mDisplayInfo.ModeCount = mDisplayInfo.GOP->Mode->MaxMode;
+  mDisplayInfo.Modes     = AllocateZeroPool (mDisplayInfo.ModeCount * sizeof (DISPLAY_MODE));
+  if (mDisplayInfo.Modes == NULL) {
+    mDisplayInfo.ModeCount = 0;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // Walk backwards so that each bucket lists its modes in ascending order.
+  for (i = mDisplayInfo.ModeCount; i-- > 0;) {
+    Mode = &mDisplayInfo.Modes[i];
+    Mode->NextInBucket = DISPLAY_MODE_NONE;
+
+    Status = mDisplayInfo.GOP->QueryMode (mDisplayInfo.GOP, i, &SizeOfInfo, &ModeInfo);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    switch (ModeInfo->PixelFormat) {
+      case PixelRedGreenBlueReserved8BitPerColor:
+      case PixelBlueGreenRedReserved8BitPerColor:
+        BitsPerPixel = 32;
+        break;
+      case PixelBitMask:
+        BitsPerPixel = (UINT32)HighBitSet32 (
+                                 ModeInfo->PixelInformation.RedMask
+                                 | ModeInfo->PixelInformation.GreenMask
+                                 | ModeInfo->PixelInformation.BlueMask
+                                 | ModeInfo->PixelInformation.ReservedMask) + 1;
+        break;
+      default:
+        BitsPerPixel = 0;
+        break;
+    }
+
+    Mode->Valid                 = TRUE;
+    Mode->HorizontalResolution  = ModeInfo->HorizontalResolution;
+    Mode->VerticalResolution    = ModeInfo->VerticalResolution;
+    Mode->PixelFormat           = ModeInfo->PixelFormat;
+    Mode->PixelsPerScanLine     = ModeInfo->PixelsPerScanLine;
+    Mode->FrameBufferSize       = (UINTN)ModeInfo->PixelsPerScanLine * ModeInfo->VerticalResolution
+                                  * ((BitsPerPixel + 7) / 8);
+    FreePool (ModeInfo);
+
+    Bucket = DisplayModeBucket (Mode->HorizontalResolution, Mode->VerticalResolution);
+    Mode->NextInBucket = mDisplayInfo.ModeBuckets[Bucket];
+    mDisplayInfo.ModeBuckets[Bucket] = i;
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Looks up the EDID of the display driven by the GOP adapter in use,
+  from EFI_EDID_ACTIVE_PROTOCOL or else EFI_EDID_DISCOVERED_PROTOCOL.
+  The console handle is usually a splitter without either, so the
+  physical GOP handle behind it is searched for: either the one
+  providing the same GOP instance, or one scanning out the same frame
+  buffer in the same resolution. The EDID of any other display is
+  never used, on machines with several it would describe the wrong one.
+
+  The result is stored in mDisplayInfo, if the base block is valid.
+
+**/
+VOID
+ReadDisplayEdid (
+  VOID
+  )
+{
+  STATIC CONST UINT8            EdidHeader[] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+  EFI_STATUS                    Status;
+  EFI_HANDLE                    *Handles;
+  UINTN                         HandleCount;
+  UINTN                         Index;
+  EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop;
+  EFI_EDID_ACTIVE_PROTOCOL      *Edid;    // same layout as EFI_EDID_DISCOVERED_PROTOCOL
+  UINT8                         Sum;
+
+  Status = gBS->LocateHandleBuffer (ByProtocol, &gEfiGraphicsOutputProtocolGuid, NULL, &HandleCount, &Handles);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  for (Index = 0; Index < HandleCount; Index++) {
+    Status = gBS->HandleProtocol (Handles[Index], &gEfiGraphicsOutputProtocolGuid, (VOID **)&Gop);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+    if ((Gop != mDisplayInfo.GOP)
+      && ((mDisplayInfo.FrameBufferBase == 0)
+        || (Gop->Mode == NULL)
+        || (Gop->Mode->Info == NULL)
+        || (Gop->Mode->FrameBufferBase != mDisplayInfo.FrameBufferBase)
+        || (Gop->Mode->Info->HorizontalResolution != mDisplayInfo.HorizontalResolution)
+        || (Gop->Mode->Info->VerticalResolution != mDisplayInfo.VerticalResolution))
+      )
+    {
+      continue;
+    }
+
+    Status = gBS->HandleProtocol (Handles[Index], &gEfiEdidActiveProtocolGuid, (VOID **)&Edid);
+    if (EFI_ERROR (Status) || (Edid->SizeOfEdid == 0)) {
+      Status = gBS->HandleProtocol (Handles[Index], &gEfiEdidDiscoveredProtocolGuid, (VOID **)&Edid);
+    }
+    if (EFI_ERROR (Status) || (Edid->Edid == NULL) || (Edid->SizeOfEdid < EDID_BLOCK_SIZE)) {
+      continue;
+    }
+
+    mDisplayInfo.Edid     = Edid->Edid;
+    mDisplayInfo.EdidSize = Edid->SizeOfEdid;
+    break;
+  }
+
+  FreePool (Handles);
+
+  if (mDisplayInfo.Edid == NULL) {
+    PrintDebug (L"No EDID found for the GOP display adapter\n");
+    return;
+  }
+
+  for (Sum = 0, Index = 0; Index < EDID_BLOCK_SIZE; Index++) {
+    Sum = (UINT8)(Sum + mDisplayInfo.Edid[Index]);
+  }
+  if ((Sum != 0) || (CompareMem (mDisplayInfo.Edid, EdidHeader, sizeof (EdidHeader)) != 0)) {
+    PrintDebug (L"EDID of the GOP display adapter is invalid, ignoring it\n");
+    mDisplayInfo.Edid     = NULL;
+    mDisplayInfo.EdidSize = 0;
+    return;
+  }
+
+  PrintDebug (L"Found EDID of the GOP display adapter (%u bytes)\n", mDisplayInfo.EdidSize);
+}
+
+
 /**
   Scans the system for Graphics Output Protocol (GOP) and
   Universal Graphic Adapter (UGA) compatible adapters/GPUs.
@@ -69,6 +246,13 @@ InitializeDisplay (
     // for MacBookAir7,2: 1536 * 900 * 4 = 5,529,600 bytes
     mDisplayInfo.FrameBufferSize       = mDisplayInfo.GOP->Mode->FrameBufferSize;
 
+    Status = BuildModeTable ();
+    if (EFI_ERROR (Status)) {
+      PrintError (L"Unable to build GOP mode table (error: %r)\n", Status);
+    }
+
+    ReadDisplayEdid ();
+
     mDisplayInfo.Protocol              = GOP;
     mDisplayInfo.AdapterFound          = TRUE;
     goto Exit;
@@ -184,6 +368,161 @@ CalculatePositionForCenter (
 }
 
 
+/**
+  Rates how well a GOP mode suits the VGA ROM shim, which needs
+  a 32bpp mode of at least the given resolution and centers its
+  screen within anything larger. Smaller framebuffers are better,
+  a stride wider than the visible width is penalized.
+
+  @param[in] Mode       GOP mode number to rate.
+  @param[in] MinWidth   Minimum screen width.
+  @param[in] MinHeight  Minimum screen height.
+
+  @retval UINT64        Score of the mode, lower is better, or
+                        DISPLAY_SCORE_UNUSABLE.
+
+**/
+UINT64
+ScoreVideoMode (
+  IN UINT32   Mode,
+  IN UINTN    MinWidth,
+  IN UINTN    MinHeight
+  )
+{
+  CONST DISPLAY_MODE  *ModeInfo;
+  UINT64              Score;
+
+  if (Mode >= mDisplayInfo.ModeCount) {
+    return DISPLAY_SCORE_UNUSABLE;
+  }
+
+  ModeInfo = &mDisplayInfo.Modes[Mode];
+  if (!ModeInfo->Valid
+    || ModeInfo->SetModeFailed
+    || (ModeInfo->HorizontalResolution < MinWidth)
+    || (ModeInfo->VerticalResolution < MinHeight)
+    || ((ModeInfo->PixelFormat != PixelBlueGreenRedReserved8BitPerColor)
+      && (ModeInfo->PixelFormat != PixelRedGreenBlueReserved8BitPerColor))
+    )
+  {
+    return DISPLAY_SCORE_UNUSABLE;
+  }
+
+  Score = ModeInfo->FrameBufferSize;
+  if (ModeInfo->PixelsPerScanLine != ModeInfo->HorizontalResolution) {
+    Score += DISPLAY_SCORE_STRIDE_PENALTY;
+  }
+
+  return Score;
+}
+
+
+/**
+  Picks the best scoring GOP mode of at least the given resolution.
+  An exact resolution match with native stride cannot be beaten, so
+  it is looked up directly before falling back to rating every mode.
+
+  @param[in] MinWidth   Minimum screen width.
+  @param[in] MinHeight  Minimum screen height.
+  @param[out] Score     Score of the chosen mode.
+  @param[out] Reason    Why the mode was chosen, for the log.
+
+  @retval UINT32        The chosen mode, or DISPLAY_MODE_NONE.
+
+**/
+UINT32
+BestVideoMode (
+  IN  UINTN           MinWidth,
+  IN  UINTN           MinHeight,
+  OUT UINT64          *Score,
+  OUT CONST CHAR16    **Reason
+  )
+{
+  UINT32  Best;
+  UINT32  i;
+  UINT64  ModeScore;
+
+  for (i = NextVideoMode (MinWidth, MinHeight, DISPLAY_MODE_NONE);
+    i != DISPLAY_MODE_NONE;
+    i = NextVideoMode (MinWidth, MinHeight, i)
+    )
+  {
+    *Score = ScoreVideoMode (i, MinWidth, MinHeight);
+    if ((*Score != DISPLAY_SCORE_UNUSABLE)
+      && (mDisplayInfo.Modes[i].PixelsPerScanLine == mDisplayInfo.Modes[i].HorizontalResolution)
+      )
+    {
+      *Reason = L"exact resolution";
+      return i;
+    }
+  }
+
+  Best   = DISPLAY_MODE_NONE;
+  *Score = DISPLAY_SCORE_UNUSABLE;
+  for (i = 0; i < mDisplayInfo.ModeCount; i++) {
+    ModeScore = ScoreVideoMode (i, MinWidth, MinHeight);
+    if (ModeScore < *Score) {
+      Best   = i;
+      *Score = ModeScore;
+    }
+  }
+
+  if (Best == DISPLAY_MODE_NONE) {
+    *Reason = L"no usable mode";
+  } else if ((mDisplayInfo.Modes[Best].HorizontalResolution == MinWidth)
+    && (mDisplayInfo.Modes[Best].VerticalResolution == MinHeight)
+    )
+  {
+    *Reason = L"exact resolution, padded stride";
+  } else {
+    *Reason = L"smallest larger mode";
+  }
+
+  return Best;
+}
+
+
+/**
+  Makes a GOP mode the current one, unless it already is.
+
+  @param[in] Mode       GOP mode number.
+
+  @retval EFI_SUCCESS   The mode is current.
+  @retval other         The firmware failed to set the mode.
+
+**/
+EFI_STATUS
+ActivateVideoMode (
+  IN UINT32   Mode
+  )
+{
+  if (Mode == mDisplayInfo.GOP->Mode->Mode) {
+    PrintDebug (L"Mode %u is already active.\n", Mode);
+    return EFI_SUCCESS;
+  }
+
+  return mDisplayInfo.GOP->SetMode (mDisplayInfo.GOP, Mode);
+}
+
+
+/**
+  Clears the text console after its geometry has changed. Clearing
+  goes through the framebuffer and can be slow on large panels, so
+  it is done at most once per boot.
+
+**/
+VOID
+ClearConsoleOnce (
+  VOID
+  )
+{
+  if (!mDisplayInfo.ConsoleCleared) {
+    gST->ConOut->ClearScreen (gST->ConOut);
+    mDisplayInfo.ConsoleCleared = TRUE;
+  }
+}
+
+
 /**
   -----------------------------------------------------------------------------
   Exported method implementations.
@@ -217,28 +556,173 @@ EnsureDisplayAvailable (
 
 
 /**
-  Switch to a video mode with specified resolution.
+  Looks up the GOP modes with a particular resolution in the mode
+  table, without calling into the firmware.
+
+  @param[in] Width      Screen width.
+  @param[in] Height     Screen height.
+  @param[in] Mode       Mode returned by the previous call, or
+                        DISPLAY_MODE_NONE to get the first one.
+
+  @retval UINT32        The next mode with the given resolution in
+                        ascending order, or DISPLAY_MODE_NONE.
+
+**/
+UINT32
+NextVideoMode (
+  IN UINTN    Width,
+  IN UINTN    Height,
+  IN UINT32   Mode
+  )
+{
+  if (mDisplayInfo.ModeCount == 0) {
+    return DISPLAY_MODE_NONE;
+  }
+
+  if (Mode == DISPLAY_MODE_NONE) {
+    Mode = mDisplayInfo.ModeBuckets[DisplayModeBucket (Width, Height)];
+  } else if (Mode < mDisplayInfo.ModeCount) {
+    Mode = mDisplayInfo.Modes[Mode].NextInBucket;
+  } else {
+    return DISPLAY_MODE_NONE;
+  }
+
+  while ((Mode != DISPLAY_MODE_NONE)
+    && ((mDisplayInfo.Modes[Mode].HorizontalResolution != Width)
+      || (mDisplayInfo.Modes[Mode].VerticalResolution != Height))
+    )
+  {
+    Mode = mDisplayInfo.Modes[Mode].NextInBucket;
+  }
+
+  return Mode;
+}
+
+
+/**
+  Extracts the preferred resolution from the EDID of the display,
+  i.e. the first detailed timing descriptor of the base block.
+
+  @param[out] Width     Preferred screen width.
+  @param[out] Height    Preferred screen height.
+
+  @retval TRUE          The EDID has a preferred timing.
+  @retval FALSE         There is no EDID or no preferred timing in it.
+
+**/
+BOOLEAN
+EdidPreferredResolution (
+  OUT UINT32  *Width,
+  OUT UINT32  *Height
+  )
+{
+  CONST UINT8   *Timing;
+
+  if (EFI_ERROR (EnsureDisplayAvailable ()) || (mDisplayInfo.Edid == NULL)) {
+    return FALSE;
+  }
+
+  // A zero pixel clock marks a display descriptor instead of a timing.
+  Timing = mDisplayInfo.Edid + EDID_DETAILED_TIMING_OFFSET;
+  if ((Timing[0] == 0) && (Timing[1] == 0)) {
+    return FALSE;
+  }
+
+  *Width  = Timing[2] | ((Timing[4] & 0xF0) << 4);
+  *Height = Timing[5] | ((Timing[7] & 0xF0) << 4);
+
+  return (*Width != 0) && (*Height != 0);
+}
+
+
+/**
+  Finds the native resolution of the display, taken to be the
+  preferred resolution from its EDID if a usable GOP mode has it,
+  or else the largest resolution of any usable GOP mode.
+
+  @param[out] Width     Native screen width.
+  @param[out] Height    Native screen height.
+
+  @retval TRUE          A usable mode was found.
+  @retval FALSE         There is no usable GOP mode.
+
+**/
+BOOLEAN
+NativeResolution (
+  OUT UINT32  *Width,
+  OUT UINT32  *Height
+  )
+{
+  CONST DISPLAY_MODE  *ModeInfo;
+  UINT64              Pixels;
+  UINT64              BestPixels;
+  UINT32              EdidWidth;
+  UINT32              EdidHeight;
+  UINT32              i;
+
+  if (EFI_ERROR (EnsureDisplayAvailable ())) {
+    return FALSE;
+  }
+
+  if (EdidPreferredResolution (&EdidWidth, &EdidHeight)) {
+    for (i = NextVideoMode (EdidWidth, EdidHeight, DISPLAY_MODE_NONE);
+         i != DISPLAY_MODE_NONE;
+         i = NextVideoMode (EdidWidth, EdidHeight, i))
+    {
+      if (ScoreVideoMode (i, 0, 0) != DISPLAY_SCORE_UNUSABLE) {
+        *Width  = EdidWidth;
+        *Height = EdidHeight;
+        return TRUE;
+      }
+    }
+    PrintDebug (L"No usable GOP mode for the EDID preferred resolution %ux%u\n", EdidWidth, EdidHeight);
+  }
+
+  BestPixels = 0;
+  for (i = 0; i < mDisplayInfo.ModeCount; i++) {
+    if (ScoreVideoMode (i, 0, 0) == DISPLAY_SCORE_UNUSABLE) {
+      continue;
+    }
+    ModeInfo = &mDisplayInfo.Modes[i];
+    Pixels   = MultU64x32 (ModeInfo->HorizontalResolution, ModeInfo->VerticalResolution);
+    if (Pixels > BestPixels) {
+      BestPixels  = Pixels;
+      *Width      = ModeInfo->HorizontalResolution;
+      *Height     = ModeInfo->VerticalResolution;
+    }
+  }
+
+  return BestPixels != 0;
+}
+
+
+/**
+  Switch to the best video mode of at least the specified resolution,
+  see ScoreVideoMode.
 
-  @param[in] Width      Desired screen width.
-  @param[in] Height     Desired screen height.
+  @param[in] Width      Minimum screen width.
+  @param[in] Height     Minimum screen height.
+  @param[in] ModeHint   GOP mode number to try before rating
+                        all modes, eg. one remembered from the
+                        previous boot, or MAX_UINT32 if none.
 
-  @retval EFI_SUCCESS   Successfully switched to a desired mode.
+  @retval EFI_SUCCESS   Successfully switched to a suitable mode.
   @retval other         Either no graphics adapter available,
                         or the graphics adapter does not support mode switching,
                         or the graphics adapter failed to switch modes.
 **/
 EFI_STATUS
 SwitchVideoMode (
-  IN UINTN  Width,
-  IN UINTN  Height
+  IN UINTN    Width,
+  IN UINTN    Height,
+  IN UINT32   ModeHint
   )
 {
   EFI_STATUS                              Status = EFI_DEVICE_ERROR;
-  UINT32                                  MaxMode;
-  UINT32                                  i;
-  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION    *ModeInfo;
-  UINTN                                   SizeOfInfo;
-  BOOLEAN                                 MatchFound = FALSE;
+  UINT32                                  PreviousMode;
+  UINT32                                  Mode;
+  UINT64                                  Score;
+  CONST CHAR16                            *Reason;
 
   if ((Width == 0) || (Height == 0)) {
     return EFI_INVALID_PARAMETER;
@@ -254,44 +738,53 @@ SwitchVideoMode (
     return EFI_UNSUPPORTED;
   }
 
-  // Try to switch to a desired resolution
-  MaxMode = mDisplayInfo.GOP->Mode->MaxMode;
-  for (i = 0; i < MaxMode; i++) {
-    Status = mDisplayInfo.GOP->QueryMode (mDisplayInfo.GOP, i, &SizeOfInfo, &ModeInfo);
-    if (!EFI_ERROR (Status)) {
-      if ((ModeInfo->HorizontalResolution == Width)
-        && (ModeInfo->VerticalResolution == Height)
-        )
-      {
-        if ((ModeInfo->PixelFormat == PixelBlueGreenRedReserved8BitPerColor)
-          || (ModeInfo->PixelFormat == PixelRedGreenBlueReserved8BitPerColor)
-          )
-        {
-          MatchFound = TRUE;
-          Status = mDisplayInfo.GOP->SetMode (mDisplayInfo.GOP, i);
-          if (EFI_ERROR (Status)) {
-            PrintError (L"Failed to switch to Mode %u with desired %ux%u resolution.\n", i, Width, Height);
-          } else {
-            PrintDebug (L"Set mode %u with desired %ux%u resolution.\n", i, Width, Height);
-            break;
-          }
-        }
-      }
+  PreviousMode = mDisplayInfo.GOP->Mode->Mode;
+
+  // A known-good mode is tried first
+  Score = ScoreVideoMode (ModeHint, Width, Height);
+  if (Score != DISPLAY_SCORE_UNUSABLE) {
+    Status = ActivateVideoMode (ModeHint);
+    if (EFI_ERROR (Status)) {
+      PrintError (L"Failed to switch to cached mode %u.\n", ModeHint);
+      mDisplayInfo.Modes[ModeHint].SetModeFailed = TRUE;
+    } else {
+      PrintDebug (L"Set cached mode %u (%ux%u, score %lu).\n", ModeHint,
+        mDisplayInfo.Modes[ModeHint].HorizontalResolution, mDisplayInfo.Modes[ModeHint].VerticalResolution, Score);
     }
   }
 
-  // Refresh mDisplayInfo
-  mDisplayInfo.HorizontalResolution  = mDisplayInfo.GOP->Mode->Info->HorizontalResolution;
-  mDisplayInfo.VerticalResolution    = mDisplayInfo.GOP->Mode->Info->VerticalResolution;
-  mDisplayInfo.PixelFormat           = mDisplayInfo.GOP->Mode->Info->PixelFormat;
-  mDisplayInfo.PixelsPerScanLine     = mDisplayInfo.GOP->Mode->Info->PixelsPerScanLine;
-  mDisplayInfo.FrameBufferBase       = mDisplayInfo.GOP->Mode->FrameBufferBase;
-  mDisplayInfo.FrameBufferSize       = mDisplayInfo.GOP->Mode->FrameBufferSize;
+  // Go down the ranking until the firmware accepts a mode
+  while (EFI_ERROR (Status)) {
+    Mode = BestVideoMode (Width, Height, &Score, &Reason);
+    if (Mode == DISPLAY_MODE_NONE) {
+      break;
+    }
+    Status = ActivateVideoMode (Mode);
+    if (EFI_ERROR (Status)) {
+      PrintError (L"Failed to switch to mode %u (%ux%u).\n", Mode,
+        mDisplayInfo.Modes[Mode].HorizontalResolution, mDisplayInfo.Modes[Mode].VerticalResolution);
+      mDisplayInfo.Modes[Mode].SetModeFailed = TRUE;
+    } else {
+      PrintDebug (L"Set mode %u (%ux%u, stride %u, score %lu): %s.\n", Mode,
+        mDisplayInfo.Modes[Mode].HorizontalResolution, mDisplayInfo.Modes[Mode].VerticalResolution,
+        mDisplayInfo.Modes[Mode].PixelsPerScanLine, Score, Reason);
+    }
+  }
 
-  gST->ConOut->ClearScreen (gST->ConOut);
+  // Refresh mDisplayInfo, nothing to do if the mode did not change
+  if (mDisplayInfo.GOP->Mode->Mode != PreviousMode) {
+    mDisplayInfo.HorizontalResolution  = mDisplayInfo.GOP->Mode->Info->HorizontalResolution;
+    mDisplayInfo.VerticalResolution    = mDisplayInfo.GOP->Mode->Info->VerticalResolution;
+    mDisplayInfo.PixelFormat           = mDisplayInfo.GOP->Mode->Info->PixelFormat;
+    mDisplayInfo.PixelsPerScanLine     = mDisplayInfo.GOP->Mode->Info->PixelsPerScanLine;
+    mDisplayInfo.FrameBufferBase       = mDisplayInfo.GOP->Mode->FrameBufferBase;
+    mDisplayInfo.FrameBufferSize       = mDisplayInfo.GOP->Mode->FrameBufferSize;
 
-  if (!MatchFound) {
-    PrintError (L"Resolution %ux%u not supported.\n", Width, Height);
+    ClearConsoleOnce ();
+  }
+
+  if (EFI_ERROR (Status)) {
+    PrintError (L"No usable mode of at least %ux%u resolution.\n", Width, Height);
   }
 
   return Status;
@@ -360,7 +853,7 @@ ForceVideoModeHack (
   mDisplayInfo.FrameBufferBase       = mDisplayInfo.GOP->Mode->FrameBufferBase;
   mDisplayInfo.FrameBufferSize       = mDisplayInfo.GOP->Mode->FrameBufferSize;
 
-  gST->ConOut->ClearScreen (gST->ConOut);
+  ClearConsoleOnce ();
 
   return Status;
 }
@@ -376,11 +869,8 @@ PrintVideoInfo (
   VOID
   )
 {
-  UINT32                                MaxMode;
   UINT32                                i;
-  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION  *ModeInfo;
-  UINTN                                 SizeOfInfo;
-  EFI_STATUS                            Status;
+  CONST DISPLAY_MODE                    *Mode;
 
   if (EFI_ERROR (EnsureDisplayAvailable ())) {
     PrintDebug (L"No display adapters found, unable to print display information\n");
@@ -397,24 +887,32 @@ PrintVideoInfo (
 
   // Query available modes.
   if (mDisplayInfo.Protocol == GOP) {
-    MaxMode = mDisplayInfo.GOP->Mode->MaxMode;
-    PrintDebug (L"Available modes (MaxMode = %u):\n", MaxMode);
-    for (i = 0; i < MaxMode; i++) {
-      Status = mDisplayInfo.GOP->QueryMode (mDisplayInfo.GOP, i, &SizeOfInfo, &ModeInfo);
-      if (!EFI_ERROR (Status)) {
-        PrintDebug (L"  Mode%u: %ux%u\n", i, ModeInfo->HorizontalResolution, ModeInfo->VerticalResolution);
+    PrintDebug (L"Available modes (MaxMode = %u):\n", mDisplayInfo.ModeCount);
+    for (i = 0; i < mDisplayInfo.ModeCount; i++) {
+      Mode = &mDisplayInfo.Modes[i];
+      if (Mode->Valid) {
+        PrintDebug (L"  Mode%u: %ux%u stride=%u format=%u fb=%u\n", i,
+          Mode->HorizontalResolution, Mode->VerticalResolution,
+          Mode->PixelsPerScanLine, Mode->PixelFormat, Mode->FrameBufferSize);
       }
     }
   }
 }
 
 /**
-  Prints important information about the currently running video
-  mode. Initializes adapters if they have not yet been detected.
+  Checks whether the current video mode is at least as large as
+  the given resolution. Initializes adapters if they have not yet
+  been detected.
+
+  @param[in] Width      Minimum screen width.
+  @param[in] Height     Minimum screen height.
+
+  @retval TRUE          The current mode is large enough.
+  @retval FALSE         It is not, or no adapter was found.
 
 **/
 BOOLEAN
-MatchCurrentResolution (
+CurrentResolutionFits (
   IN UINTN  Width,
   IN UINTN  Height
   )
@@ -422,8 +920,8 @@ MatchCurrentResolution (
   if ((Width != 0) && (Height != 0)) {
     if (EFI_ERROR (EnsureDisplayAvailable ())) {
       PrintDebug (L"No display adapters found, unable to print display information\n");
-    } else if ((mDisplayInfo.HorizontalResolution == Width)
-      && (mDisplayInfo.VerticalResolution == Height)
+    } else if ((mDisplayInfo.HorizontalResolution >= Width)
+      && (mDisplayInfo.VerticalResolution >= Height)
       )
     {
       return TRUE;
@@ -17,6 +17,22 @@
 #define __DISPLAY_H
 
 
+/**
+  -----------------------------------------------------------------------------
+  Constants.
+  -----------------------------------------------------------------------------
+**/
+
+#define DISPLAY_MODE_BUCKETS    64      // must be a power of two
+#define DISPLAY_MODE_NONE       MAX_UINT32
+
+#define DISPLAY_SCORE_UNUSABLE        MAX_UINT64
+#define DISPLAY_SCORE_STRIDE_PENALTY  SIZE_1MB
+
+#define EDID_BLOCK_SIZE               128
+#define EDID_DETAILED_TIMING_OFFSET   54      // first one holds the preferred timing
+
+
 /**
   -----------------------------------------------------------------------------
   Includes.
@@ -25,6 +41,8 @@
 
 #include <Uefi.h>
 
+#include <Protocol/EdidActive.h>
+#include <Protocol/EdidDiscovered.h>
 #include <Protocol/GraphicsOutput.h>
 #include <Protocol/LoadedImage.h>
 #include <Protocol/UgaDraw.h>
@@ -54,9 +72,25 @@ typedef enum {
   UGA
 } GRAPHICS_PROTOCOL;
 
+//
+// One GOP mode, as reported by QueryMode once during InitializeDisplay.
+// Modes with the same resolution hash are chained through NextInBucket.
+//
+typedef struct {
+  BOOLEAN                       Valid;
+  UINT32                        HorizontalResolution;
+  UINT32                        VerticalResolution;
+  EFI_GRAPHICS_PIXEL_FORMAT     PixelFormat;
+  UINT32                        PixelsPerScanLine;
+  UINTN                         FrameBufferSize;
+  BOOLEAN                       SetModeFailed;
+  UINT32                        NextInBucket;
+} DISPLAY_MODE;
+
 typedef struct {
   BOOLEAN                       Initialized;
   BOOLEAN                       AdapterFound;
+  BOOLEAN                       ConsoleCleared;
 
   GRAPHICS_PROTOCOL             Protocol;
   EFI_UGA_DRAW_PROTOCOL         *UGA;
@@ -68,6 +102,15 @@ typedef struct {
   UINT32                        PixelsPerScanLine;
   EFI_PHYSICAL_ADDRESS          FrameBufferBase;
   UINTN                         FrameBufferSize;
+
+  // GOP mode table, indexed by mode number.
+  DISPLAY_MODE                  *Modes;
+  UINT32                        ModeCount;
+  UINT32                        ModeBuckets[DISPLAY_MODE_BUCKETS];
+
+  // EDID of the display, owned by the GOP driver. Validated, or NULL.
+  UINT8                         *Edid;
+  UINT32                        EdidSize;
 } DISPLAY_INFO;
 
 #pragma pack(1)
@@ -116,8 +159,28 @@ SwitchToText (
 
 EFI_STATUS
 SwitchVideoMode (
-  IN UINTN  Width,
-  IN UINTN  Height
+  IN UINTN    Width,
+  IN UINTN    Height,
+  IN UINT32   ModeHint
+  );
+
+BOOLEAN
+EdidPreferredResolution (
+  OUT UINT32  *Width,
+  OUT UINT32  *Height
+  );
+
+BOOLEAN
+NativeResolution (
+  OUT UINT32  *Width,
+  OUT UINT32  *Height
+  );
+
+UINT32
+NextVideoMode (
+  IN UINTN    Width,
+  IN UINTN    Height,
+  IN UINT32   Mode
   );
 
 EFI_STATUS
@@ -127,7 +190,7 @@ ForceVideoModeHack (
   );
 
 BOOLEAN
-MatchCurrentResolution (
+CurrentResolutionFits (
   IN UINTN  Width,
   IN UINTN  Height
   );
@@ -14,9 +14,146 @@
 **/
 
 #include "Filesystem.h"
+#include "Log.h"
+#include "Timing.h"
 #include "Util.h"
 
 
+/**
+  -----------------------------------------------------------------------------
+  Variables.
+  -----------------------------------------------------------------------------
+**/
+
+STATIC DIRECTORY_CACHE  mDirectoryCache;
+
+
+/**
+  -----------------------------------------------------------------------------
+  Local method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Returns the length of the directory part of a file path,
+  including the trailing backslash.
+
+  @param[in] FilePath     Path to a file.
+
+  @retval 0               The path contains no directory part.
+  @retval other           Number of characters up to and including
+                          the last backslash.
+
+**/
+UINTN
+GetDirectoryPathLength (
+  IN  CHAR16  *FilePath
+  )
+{
+  UINTN   Length;
+
+  if (FilePath == NULL) {
+    return 0;
+  }
+
+  for (Length = StrLen (FilePath); Length > 0; Length--) {
+    if (FilePath[Length - 1] == L'\\') {
+      break;
+    }
+  }
+
+  return Length;
+}
+
+
+/**
+  Adds a copy of the specified file information to the
+  directory cache.
+
+  @param[in] FileInfo     File information to be added.
+
+  @retval EFI_SUCCESS     The entry was added.
+  @retval other           Not enough memory to add the entry.
+
+**/
+EFI_STATUS
+AddDirectoryCacheEntry (
+  IN  EFI_FILE_INFO   *FileInfo
+  )
+{
+  EFI_FILE_INFO   **Entries;
+  UINTN           Capacity;
+
+  if (mDirectoryCache.EntryCount == mDirectoryCache.EntryCapacity) {
+    Capacity = (mDirectoryCache.EntryCapacity == 0) ? 16 : mDirectoryCache.EntryCapacity * 2;
+    Entries  = ReallocatePool (
+                 mDirectoryCache.EntryCapacity * sizeof (EFI_FILE_INFO *),
+                 Capacity * sizeof (EFI_FILE_INFO *),
+                 mDirectoryCache.Entries
+                 );
+    if (Entries == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    mDirectoryCache.Entries       = Entries;
+    mDirectoryCache.EntryCapacity = Capacity;
+  }
+
+  mDirectoryCache.Entries[mDirectoryCache.EntryCount] = AllocateCopyPool ((UINTN)FileInfo->Size, FileInfo);
+  if (mDirectoryCache.Entries[mDirectoryCache.EntryCount] == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  mDirectoryCache.EntryCount++;
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Looks up a file in the directory cache.
+
+  @param[in] FilePath     Path to the file to look up.
+  @param[out] Index       Index of the matching cache entry, or
+                          EntryCount if the file does not exist.
+
+  @retval TRUE            The file resides in the cached directory
+                          and Index is valid.
+  @retval FALSE           The file resides elsewhere (or nothing is
+                          cached) and has to be looked up on disk.
+
+**/
+BOOLEAN
+LookupDirectoryCache (
+  IN  CHAR16  *FilePath,
+  OUT UINTN   *Index
+  )
+{
+  UINTN   DirectoryPathLength;
+
+  *Index = 0;
+
+  if ((mDirectoryCache.DirectoryPath == NULL) || (FilePath == NULL)) {
+    return FALSE;
+  }
+
+  DirectoryPathLength = GetDirectoryPathLength (FilePath);
+  if ((DirectoryPathLength != mDirectoryCache.DirectoryPathLength)
+    || (StrnCmpNoCase (FilePath, mDirectoryCache.DirectoryPath, DirectoryPathLength) != 0)
+    )
+  {
+    return FALSE;
+  }
+
+  for (*Index = 0; *Index < mDirectoryCache.EntryCount; (*Index)++) {
+    if (StrnCmpNoCase (mDirectoryCache.Entries[*Index]->FileName, FilePath + DirectoryPathLength, MAX_UINTN) == 0) {
+      break;
+    }
+  }
+
+  return TRUE;
+}
+
+
 /**
   -----------------------------------------------------------------------------
   Exported method implementations.
@@ -24,6 +161,212 @@
 **/
 
 
+/**
+  Enumerates the directory containing the specified file once
+  and keeps information about all its entries in memory. Later
+  existence checks and size lookups for files in that directory
+  are answered from memory instead of the disk.
+
+  @param[in] VolumeRoot   Root of the volume to be scanned.
+  @param[in] FilePath     Path to any file in the directory
+                          to be scanned.
+
+  @retval EFI_SUCCESS     The directory was enumerated.
+  @retval other           The directory could not be enumerated;
+                          all lookups will go to disk.
+
+**/
+EFI_STATUS
+ScanDirectory (
+  IN  EFI_FILE_HANDLE   VolumeRoot,
+  IN  CHAR16            *FilePath
+  )
+{
+  EFI_STATUS        Status;
+  EFI_FILE_HANDLE   Directory = NULL;
+  EFI_FILE_INFO     *FileInfo = NULL;
+  UINTN             FileInfoSize;
+  UINTN             BufferSize;
+  CHAR16            *DirectoryPath;
+  UINTN             DirectoryPathLength;
+
+  if ((VolumeRoot == NULL) || (FilePath == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FreeDirectoryCache ();
+
+  DirectoryPathLength = GetDirectoryPathLength (FilePath);
+  if (DirectoryPathLength == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  DirectoryPath = AllocateZeroPool ((DirectoryPathLength + 1) * sizeof (CHAR16));
+  if (DirectoryPath == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  CopyMem (DirectoryPath, FilePath, DirectoryPathLength * sizeof (CHAR16));
+
+  // Open the directory itself, without the trailing backslash unless it is the root.
+  if (DirectoryPathLength > 1) {
+    DirectoryPath[DirectoryPathLength - 1] = L'\0';
+  }
+  Status = VolumeRoot->Open (VolumeRoot, &Directory, DirectoryPath, EFI_FILE_MODE_READ, 0);
+  DirectoryPath[DirectoryPathLength - 1] = L'\\';
+  if (EFI_ERROR (Status)) {
+    PrintDebug (L"Unable to open directory '%s' (error: %r)\n", DirectoryPath, Status);
+    goto Exit;
+  }
+
+  BufferSize = SIZE_OF_EFI_FILE_INFO + 256 * sizeof (CHAR16);
+  FileInfo = AllocatePool (BufferSize);
+  if (FileInfo == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  for (;;) {
+    FileInfoSize = BufferSize;
+    Status = Directory->Read (Directory, &FileInfoSize, FileInfo);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      FreePool (FileInfo);
+      BufferSize = FileInfoSize;
+      FileInfo = AllocatePool (BufferSize);
+      if (FileInfo == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+      continue;
+    }
+    if (EFI_ERROR (Status) || (FileInfoSize == 0)) {
+      break;
+    }
+    if ((StrCmp (FileInfo->FileName, L".") == 0) || (StrCmp (FileInfo->FileName, L"..") == 0)) {
+      continue;
+    }
+    Status = AddDirectoryCacheEntry (FileInfo);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+  }
+
+  Exit:
+
+  if (FileInfo != NULL) {
+    FreePool (FileInfo);
+  }
+  if (Directory != NULL) {
+    Directory->Close (Directory);
+  }
+
+  if (EFI_ERROR (Status)) {
+    FreeDirectoryCache ();
+    FreePool (DirectoryPath);
+  } else {
+    mDirectoryCache.DirectoryPath       = DirectoryPath;
+    mDirectoryCache.DirectoryPathLength = DirectoryPathLength;
+    PrintDebug (L"Cached %u entries of directory '%s'\n", mDirectoryCache.EntryCount, DirectoryPath);
+  }
+
+  return Status;
+}
+
+
+/**
+  Keeps the directory cache coherent after a file in the cached
+  directory has been created, modified or deleted.
+
+  @param[in] FilePath     Path to the file that changed.
+  @param[in] FileInfo     Current information about the file,
+                          or NULL if the file has been deleted.
+
+**/
+VOID
+UpdateDirectoryCache (
+  IN  CHAR16            *FilePath,
+  IN  EFI_FILE_INFO     *FileInfo   OPTIONAL
+  )
+{
+  UINTN   Index;
+
+  if (!LookupDirectoryCache (FilePath, &Index)) {
+    return;
+  }
+
+  if (Index < mDirectoryCache.EntryCount) {
+    FreePool (mDirectoryCache.Entries[Index]);
+    mDirectoryCache.EntryCount--;
+    mDirectoryCache.Entries[Index] = mDirectoryCache.Entries[mDirectoryCache.EntryCount];
+  }
+
+  if ((FileInfo != NULL) && EFI_ERROR (AddDirectoryCacheEntry (FileInfo))) {
+    // Cannot keep track of this file anymore, fall back to disk lookups.
+    FreeDirectoryCache ();
+  }
+}
+
+
+/**
+  Retrieves information about a file from the directory cache
+  without touching the disk.
+
+  @param[in] FilePath     Path to the file to look up.
+  @param[out] FileInfo    Cached information about the file, or
+                          NULL if the file does not exist. Owned
+                          by the cache and must not be freed.
+
+  @retval TRUE            The answer came from the cache.
+  @retval FALSE           The file is not in the cached directory
+                          and nothing is known about it.
+
+**/
+BOOLEAN
+GetCachedFileInfo (
+  IN  CHAR16                *FilePath,
+  OUT CONST EFI_FILE_INFO   **FileInfo
+  )
+{
+  UINTN   Index;
+
+  *FileInfo = NULL;
+
+  if (!LookupDirectoryCache (FilePath, &Index)) {
+    return FALSE;
+  }
+
+  if (Index < mDirectoryCache.EntryCount) {
+    *FileInfo = mDirectoryCache.Entries[Index];
+  }
+
+  return TRUE;
+}
+
+
+/**
+  Releases all resources held by the directory cache.
+
+**/
+VOID
+FreeDirectoryCache (
+  VOID
+  )
+{
+  UINTN   Index;
+
+  for (Index = 0; Index < mDirectoryCache.EntryCount; Index++) {
+    FreePool (mDirectoryCache.Entries[Index]);
+  }
+  if (mDirectoryCache.Entries != NULL) {
+    FreePool (mDirectoryCache.Entries);
+  }
+  if (mDirectoryCache.DirectoryPath != NULL) {
+    FreePool (mDirectoryCache.DirectoryPath);
+  }
+
+  ZeroMem (&mDirectoryCache, sizeof (DIRECTORY_CACHE));
+}
+
+
 EFI_FILE_INFO *
 GetFileInfo (
   IN  EFI_FILE_HANDLE    FileHandle
@@ -220,8 +563,8 @@ GetBaseFilename (
                           path whose existence will be checked.
 
   @retval TRUE            File exists at the specified location.
-  @retval FALSE           File does not exist or other problems
-                          were encountered during execution.
+  @retval FALSE           File does not exist, is a directory or other
+                          problems were encountered during execution.
 
 **/
 BOOLEAN
@@ -232,21 +575,37 @@ FileExists (
 {
   EFI_STATUS        Status;
   EFI_FILE_HANDLE   RequestedFile;
+  EFI_FILE_INFO     *FileInfo;
+  BOOLEAN           IsFile;
+  UINTN             Index;
 
   if ((VolumeRoot == NULL) || (FilePath == NULL)) {
     return FALSE;
   }
 
+  // Answer from the directory cache if possible, directories do not count.
+  if (LookupDirectoryCache (FilePath, &Index)) {
+    IsFile = (Index < mDirectoryCache.EntryCount)
+      && ((mDirectoryCache.Entries[Index]->Attribute & EFI_FILE_DIRECTORY) == 0);
+    PrintDebug (L"File '%s' %s in directory cache\n", FilePath, IsFile ? L"found" : L"not found");
+    return IsFile;
+  }
+
   // Try to open file for reading.
   Status = VolumeRoot->Open (VolumeRoot, &RequestedFile, FilePath, EFI_FILE_MODE_READ, 0);
   if (EFI_ERROR (Status)) {
     PrintDebug (L"Unable to open file '%s' for reading (error: %r)\n", FilePath, Status);
     return FALSE;
-  } else {
-    PrintDebug (L"Opened file '%s' for reading\n", FilePath);
-    RequestedFile->Close (RequestedFile);
-    return TRUE;
   }
+
+  FileInfo = GetFileInfo (RequestedFile);
+  IsFile   = (FileInfo != NULL) && ((FileInfo->Attribute & EFI_FILE_DIRECTORY) == 0);
+  PrintDebug (L"Opened %s '%s' for reading\n", IsFile ? L"file" : L"directory", FilePath);
+  if (FileInfo != NULL) {
+    FreePool (FileInfo);
+  }
+  RequestedFile->Close (RequestedFile);
+  return IsFile;
 }
 
 BOOLEAN
@@ -258,11 +617,18 @@ FileDelete (
   EFI_STATUS        Status;
   EFI_FILE_HANDLE   RequestedFile;
   EFI_FILE_INFO     *FileInfo;
+  UINTN             Index;
 
   if ((VolumeRoot == NULL) || (FilePath == NULL)) {
     return FALSE;
   }
 
+  // Nothing to delete if the directory cache knows the file does not exist.
+  if (LookupDirectoryCache (FilePath, &Index) && (Index == mDirectoryCache.EntryCount)) {
+    PrintDebug (L"File '%s' not found in directory cache, nothing to delete\n", FilePath);
+    return FALSE;
+  }
+
   // Try to open file for deletion.
   Status = VolumeRoot->Open (VolumeRoot, &RequestedFile, FilePath, EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE, 0);
   if (EFI_ERROR (Status)) {
@@ -275,6 +641,7 @@ FileDelete (
       // Delete if its not directory.
       if ((FileInfo->Attribute & EFI_FILE_DIRECTORY) == 0) {
         RequestedFile->Delete (RequestedFile);
+        UpdateDirectoryCache (FilePath, NULL);
       }
       FreePool (FileInfo);
     }
@@ -310,9 +677,16 @@ FileWrite (
       // Write if its not directory.
       if ((FileInfo->Attribute & EFI_FILE_DIRECTORY) == 0) {
         RequestedFile->Write (RequestedFile, &BufferSize, Buffer);
+        FreePool (FileInfo);
+        FileInfo = GetFileInfo (RequestedFile);
+        if (FileInfo != NULL) {
+          UpdateDirectoryCache (FilePath, FileInfo);
+        }
         RequestedFile->Close (RequestedFile);
       }
-      FreePool (FileInfo);
+      if (FileInfo != NULL) {
+        FreePool (FileInfo);
+      }
     }
     return TRUE;
   }
@@ -356,11 +730,22 @@ FileRead (
   EFI_FILE_HANDLE         File = NULL;
   EFI_FILE_INFO           *FileInfo;
   UINTN                   Size;
+  UINTN                   Index;
+  BOOLEAN                 Cached;
 
   if ((VolumeRoot == NULL) || (FilePath == NULL) || (FileContents == NULL) || (FileBytes == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
+  *FileContents = NULL;
+
+  // Skip the disk entirely if the directory cache knows the file does not exist.
+  Cached = LookupDirectoryCache (FilePath, &Index);
+  if (Cached && (Index == mDirectoryCache.EntryCount)) {
+    PrintDebug (L"File '%s' not found in directory cache\n", FilePath);
+    return EFI_NOT_FOUND;
+  }
+
   // Try to open file for reading.
   Status = VolumeRoot->Open (VolumeRoot, &File, FilePath, EFI_FILE_MODE_READ, 0);
   if (EFI_ERROR (Status)) {
@@ -371,13 +756,17 @@ FileRead (
   }
 
   // First gather information on total file size.
-  FileInfo = GetFileInfo (File);
-  if (FileInfo == NULL) {
-    Status = EFI_UNSUPPORTED;
-    goto Exit;
+  if (Cached) {
+    Size = (UINTN)mDirectoryCache.Entries[Index]->FileSize;
+  } else {
+    FileInfo = GetFileInfo (File);
+    if (FileInfo == NULL) {
+      Status = EFI_UNSUPPORTED;
+      goto Exit;
+    }
+    Size = (UINTN)FileInfo->FileSize;
+    FreePool (FileInfo);
   }
-  Size = FileInfo->FileSize;
-  FreePool (FileInfo);
 
   // Allocate a buffer...
   *FileContents = AllocatePool (Size);
@@ -434,6 +823,7 @@ CheckBootMgrGuid (
     return Status;
   }
 
+  PhaseBegin (PhaseCheckBootMgrGuid);
   for (Address = ImageBase;
     Address < ImageBase + ImageSize - sizeof (EFI_GUID);
     Address += sizeof (VOID *)
@@ -445,6 +835,7 @@ CheckBootMgrGuid (
       break;
     }
   }
+  PhaseEnd (PhaseCheckBootMgrGuid);
 
   return Status;
 }
@@ -471,7 +862,9 @@ Launch (
   //
   FilePathOnDevice      = FileDevicePath (mUefiSevenImageInfo->DeviceHandle, FilePath);
   FilePathOnDeviceText  = ConvertDevicePathToText (FilePathOnDevice, TRUE, FALSE);
+  PhaseBegin (PhaseLoadImage);
   Status = gBS->LoadImage (TRUE, mUefiSevenImage, FilePathOnDevice, NULL, 0, &FileImageHandle);
+  PhaseEnd (PhaseLoadImage);
   if (EFI_ERROR (Status)) {
     PrintError (L"Unable to load '%s' (error: %r)\n", FilePathOnDeviceText, Status);
   } else {
@@ -498,10 +891,17 @@ Launch (
     PrintDebug (L"File matches an EFI loader signature\n");
   }
 
+  PrintBootTimings ();
+
   if (WaitForEnterCallback != NULL) {
     WaitForEnterCallback (TRUE);
   }
 
+  //
+  // Nothing gets logged from here on unless the boot fails.
+  //
+  LogFlush ();
+
   //
   // Launch!
   //
@@ -40,6 +40,21 @@
 #include <Library/UefiLib.h>
 
 
+/**
+  -----------------------------------------------------------------------------
+  Type definitions and enums.
+  -----------------------------------------------------------------------------
+**/
+
+typedef struct {
+  CHAR16          *DirectoryPath;       // including the trailing backslash
+  UINTN           DirectoryPathLength;
+  EFI_FILE_INFO   **Entries;
+  UINTN           EntryCount;
+  UINTN           EntryCapacity;
+} DIRECTORY_CACHE;
+
+
 /**
   -----------------------------------------------------------------------------
   Exported method signatures.
@@ -51,6 +66,29 @@ GetFileInfo (
   IN  EFI_FILE_HANDLE    FileHandle
   );
 
+EFI_STATUS
+ScanDirectory (
+  IN  EFI_FILE_HANDLE   VolumeRoot,
+  IN  CHAR16            *FilePath
+  );
+
+VOID
+UpdateDirectoryCache (
+  IN  CHAR16            *FilePath,
+  IN  EFI_FILE_INFO     *FileInfo   OPTIONAL
+  );
+
+BOOLEAN
+GetCachedFileInfo (
+  IN  CHAR16                *FilePath,
+  OUT CONST EFI_FILE_INFO   **FileInfo
+  );
+
+VOID
+FreeDirectoryCache (
+  VOID
+  );
+
 BOOLEAN
 FileExists (
   IN  EFI_FILE_HANDLE   VolumeRoot,
@@ -1,8 +1,8 @@
 ;------------------------------------------------------------------------------
 ; @file
 ; A minimal Int10h stub that allows the Windows 7 SP1 default VGA driver to
-; 'swithc' to the 1024x768x32 video mode on devices that do not have a VGA ROM
-; or Int10h handler.
+; 'swithc' to the 1024x768x32 video mode, or any other mode in the table
+; built by UefiSeven, on devices that do not have a VGA ROM or Int10h handler.
 ;
 ; Adapted from VbeShim.asm from the Qemu project.
 ;
@@ -21,9 +21,17 @@
 ;
 ;------------------------------------------------------------------------------
 
-; Uncomment the following to enable serial console output on COM1
+; Int10hHandler.sh builds this twice, as is and with both of the following
+; defined for the instrumented handler selected with handler=trace.
+;
+; DEBUG enables serial console output, on the UART and at the baud rate given
+; in the shim header (handler_port and handler_baud, no output if the port is 0)
 ;%define DEBUG
 
+; TRACE records every call in the trace ring set up by UefiSeven, see
+; ShimDecode.py
+;%define TRACE
+
 %macro DebugLog 1
 %ifdef DEBUG
   push       si
@@ -33,6 +41,41 @@
 %endif
 %endmacro
 
+; Counts a call in the shim header fields within the data segment,
+; which stay writable when the VGA ROM is locked
+%macro CountCall 1
+  push       ds
+  mov        ds, [cs:ShimDataSegment]
+  inc        word [%1]
+  pop        ds
+%endmacro
+
+; SHIM_HEADER fields, keep in sync with UefiSeven.h
+%define ShimModeCount       ShimHeader + 4
+%define ShimModeTable       ShimHeader + 6
+%define ShimCurrentMode     ShimHeader + 8
+%define ShimVbeHits         ShimHeader + 10   ; one word per VbeFunctions entry
+%define ShimLegacyHits      ShimHeader + 54   ; one word per LegacyFunctions entry
+%define ShimOtherHits       ShimHeader + 118  ; calls outside of both tables
+%define ShimTraceOffset     ShimHeader + 120  ; trace ring, 0 if there is none
+%define ShimTraceEntries    ShimHeader + 122
+%define ShimTraceHead       ShimHeader + 124  ; entry the next call goes to
+%define ShimTraceSlot       ShimHeader + 126  ; entry of the call in progress
+%define ShimTraceCalls      ShimHeader + 128  ; dword, calls since boot
+%define ShimSerialPort      ShimHeader + 132  ; UART base port for DEBUG
+%define ShimSerialDivisor   ShimHeader + 134
+%define ShimSerialReady     ShimHeader + 136  ; byte, UART already programmed
+%define ShimEdidOffset      ShimHeader + 137  ; EDID blocks of the display
+%define ShimEdidBlocks      ShimHeader + 139  ; 0 without EDID
+%define ShimDataSegment     ShimHeader + 141  ; where the writable fields live
+
+; Number of entries in the dispatch tables
+%define VBE_FUNCTIONS       0x16
+%define LEGACY_FUNCTIONS    0x20
+
+; VBE mode numbers of the mode table entries start here
+%define FIRST_MODE          0x00f1
+
 BITS 16
 ORG 0
 
@@ -41,41 +84,68 @@ VbeInfo:
 TIMES 256 nop             ; this will be filled in by the efi shim
 
 
-VbeModeInfo:
+ShimHeader:
 TIMES 256 nop             ; this will be filled in by the efi shim
 
 
 InterruptHandlerEntry:
   ; Main entry point for the interrupt handler
   ; http://wiki.osdev.org/BIOS#Common_functions
+  ;
+  ; Function numbers index the VbeFunctions and LegacyFunctions tables
+  ; below, anything without an entry of its own returns right away.
+  ; Every call is counted in the shim header fields within the data
+  ; segment, a page below 640 KiB while the shim is in a locked VGA ROM.
 
   DebugLog   StrInterruptHandlerEntry
 
-  cmp        ax, 0x4f00
-  je         GetInfo
-
-  cmp        ax, 0x4f01
-  je         GetModeInfo
-
-  cmp        ax, 0x4f02
-  je         SetMode
-
-  cmp        ax, 0x4f03
-  je         GetMode
-
-  cmp        ax, 0x4f10
-  je         GetPmCapabilities
-
-  cmp        ax, 0x4f15
-  je         ReadEdid
-
-  cmp        ah, 0x00
-  je         SetModeLegacy
-
-  DebugLog   StrUnknownFunction
+%ifdef TRACE
+  call       TraceEnter
+  pushf                   ; have the iret of the function come back to
+  push       cs           ; TraceLeave before returning to the caller
+  push       TraceLeave
+%endif
 
-Hang:
-  jmp        Hang
+  push       bx           ; keep BX, several functions take it as input
+  push       bx           ; room for the address of the function
+  push       bp
+  mov        bp, sp
+
+  cmp        ah, 0x4f
+  je         DispatchVbe
+  cmp        ah, LEGACY_FUNCTIONS
+  jb         DispatchLegacy
+
+  CountCall  ShimOtherHits
+  mov        bx, UnknownLegacy
+  jmp        Dispatch
+
+DispatchVbe:
+  cmp        al, VBE_FUNCTIONS
+  jb         DispatchKnownVbe
+  CountCall  ShimOtherHits
+  mov        bx, Unsupported
+  jmp        Dispatch
+DispatchKnownVbe:
+  mov        bl, al
+  xor        bh, bh
+  shl        bx, 1        ; word index into VbeFunctions and ShimVbeHits
+  CountCall  ShimVbeHits + bx
+  mov        bx, [cs:VbeFunctions + bx]
+  jmp        Dispatch
+
+DispatchLegacy:
+  mov        bl, ah
+  xor        bh, bh
+  shl        bx, 1        ; word index into LegacyFunctions and ShimLegacyHits
+  CountCall  ShimLegacyHits + bx
+  mov        bx, [cs:LegacyFunctions + bx]
+
+Dispatch:
+  mov        [bp + 2], bx ; address of the function
+  mov        bx, [bp + 4] ; restore BX
+  pop        bp
+  ret        2            ; jump to the function, dropping the saved BX
 
 
 GetInfo:
@@ -115,33 +185,37 @@ GetModeInfo:
   ;   ES:DI = pointer to VESA_BIOS_EXTENSIONS_MODE_INFORMATION_BLOCK buffer
   ; Outputs:
   ;   AX    = return status
-  push       es           ; store registers on stack
-  push       di
-  push       ds
-  push       si
-  push       cx
+  push       cx           ; store registers on stack
 
   DebugLog   StrEnterGetModeInfo
 
-  and        cx, ~0x4000  ; clear potentially set LFB (linear frame buffer) bit in mode number
-  cmp        cx, 0x00f1   ; offer information on only known mode
-  je         GetKnownModeInfo1
+  and        cx, 0x01ff   ; clear LFB (linear frame buffer) and other flags in mode number
+  sub        cx, FIRST_MODE ; turn mode number into mode table index
+  cmp        cx, [cs:ShimModeCount] ; offer information on known modes only
+  jb         GetKnownModeInfo
 
   DebugLog   StrUnknownMode
 
-  jmp        Hang
-GetKnownModeInfo1:
+  pop        cx           ; restore registers from stack
+  jmp        Unsupported  ; ax=0x014f
+GetKnownModeInfo:
+  push       es
+  push       di
+  push       ds
+  push       si
   push       cs
   pop        ds           ; load the code segment address to DS
-  mov        si, VbeModeInfo ; load offset of VbeModeInfo from program start to SI
+  mov        si, cx
+  shl        si, 8        ; every VbeModeInfo in the mode table is 256 bytes
+  add        si, [ShimModeTable] ; load offset of VbeModeInfo from program start to SI
   mov        cx, 256      ; we want to copy 256 bytes
   cld                     ; clear direction flag
   rep movsb               ; move 256 bytes of VbeModeInfo at DS:SI to buffer at ES:DI
-  pop        cx           ; restore registers from stack
-  pop        si
+  pop        si           ; restore registers from stack
   pop        ds
   pop        di
   pop        es
+  pop        cx
   jmp        Success      ; ax=0x4f
 
 
@@ -158,21 +232,37 @@ SetMode:
 
   DebugLog   StrEnterSetMode
 
-  cmp        bx, 0x40f1   ; 0x40f1 mode
+                          ; BX bits:
                           ; <15>=0 Clear display memory
                           ; <14>=1 Use linear/flat frame buffer model
                           ; <13:12>=00 Reserved (must be 0)
                           ; <11>=0 Use current default refresh rate
                           ; <10:9>00
-                          ; <8:0>=011110001 Mode Number 241 ???
+                          ; <8:0> Mode Number, FIRST_MODE and up
                           ; to identify available modes use sudo hwinfo --framebuffer
-  je         SetKnownMode1
-
+  test       bx, 0x4000   ; only the linear frame buffer model is supported
+  jz         SetUnknownMode
+  mov        ax, bx
+  and        ax, 0x01ff
+  sub        ax, FIRST_MODE ; turn mode number into mode table index
+  cmp        ax, [cs:ShimModeCount]
+  jb         SetKnownMode
+
+SetUnknownMode:
   DebugLog   StrUnknownMode
 
-  jmp        Hang
-SetKnownMode1:
-  ; everything is done by the efi shim
+  pop        ax           ; restore registers from stack
+  pop        dx
+  jmp        Unsupported  ; ax=0x014f
+SetKnownMode:
+  ; everything else is done by the efi shim, just remember the mode
+  ; in the data segment, which stays writable when the ROM is locked
+  push       ds
+  mov        ds, [cs:ShimDataSegment]
+  mov        ax, bx
+  and        ax, 0x41ff
+  mov        [ShimCurrentMode], ax
+  pop        ds
   pop        ax           ; restore registers from stack
   pop        dx
   jmp        Success      ; ax=0x4f
@@ -187,7 +277,10 @@ GetMode:
   ;   BX    = current mode
   DebugLog   StrEnterGetMode
 
-  mov        bx, 0x40f1
+  push       ds
+  mov        ds, [cs:ShimDataSegment]
+  mov        bx, [ShimCurrentMode]
+  pop        ds
   jmp        Success ; ax=0x4f
 
 
@@ -209,16 +302,52 @@ ReadEdid:
   ; Function 15: implement VBE/DDC service
   ; Inputs:
   ;   AX    = 0x4f15
-  ;   BL    = report VBE/DDC capabilities
-  ;   ES:DI = null pointer
+  ;   BL    = 0x00 to report VBE/DDC capabilities, 0x01 to read EDID
+  ;   CX    = controller unit number, only one is supported
+  ;   DX    = EDID block number (BL = 0x01)
+  ;   ES:DI = null pointer (BL = 0x00), 128 byte buffer (BL = 0x01)
   ; Outputs:
   ;   AX    = return status
-  ;   BH    = approx. time in seconds to transfer EDID block
-  ;   BL    = DDC level supported
+  ;   BH    = approx. time in seconds to transfer EDID block (BL = 0x00)
+  ;   BL    = DDC level supported (BL = 0x00)
+  ; Notes:
+  ;   The EDID was read by the efi shim and is copied from the shim.
   DebugLog   StrReadEdid
 
+  cmp        word [cs:ShimEdidBlocks], 0
+  je         ReadEdidUnsupported
+  cmp        bl, 0x00
+  je         ReportDdc
+  cmp        bl, 0x01
+  je         ReadEdidBlock
+ReadEdidUnsupported:
   jmp        Unsupported  ; ax=0x014f
 
+ReportDdc:
+  mov        bx, 0x0002   ; DDC2, no time needed to transfer a block
+  jmp        Success      ; ax=0x4f
+
+ReadEdidBlock:
+  cmp        dx, [cs:ShimEdidBlocks]
+  jae        ReadEdidUnsupported
+  push       di           ; store registers on stack
+  push       ds
+  push       si
+  push       cx
+  push       cs
+  pop        ds           ; load the code segment address to DS
+  mov        si, dx
+  shl        si, 7        ; every EDID block is 128 bytes
+  add        si, [ShimEdidOffset] ; load offset of the EDID block from program start to SI
+  mov        cx, 128      ; we want to copy 128 bytes
+  cld                     ; clear direction flag
+  rep movsb               ; move 128 bytes of EDID at DS:SI to buffer at ES:DI
+  pop        cx           ; restore registers from stack
+  pop        si
+  pop        ds
+  pop        di
+  jmp        Success      ; ax=0x4f
+
 
 SetModeLegacy:
   ; Inputs:
@@ -227,25 +356,85 @@ SetModeLegacy:
   ; Outputs:
   ;   AL    = video mode flag (20h for mode > 7, 30h for 0-5,7 and 3Fh for 6)
   ; Notes:
-  ;   We only pretend to do something here, don't set any modes.
+  ;   We only pretend to do something here, don't set any modes. Windows
+  ;   asks for 0x03 (80x25 text) and 0x12 (640x480x16), anything else
+  ;   gets the flag it would get from a real VGA BIOS as well.
   DebugLog   StrEnterSetModeLegacy
 
-  cmp        al, 0x03     ; 80x25 chars @ 720x400x16
-  je         SetKnownModeLegacy1
-  cmp        al, 0x12     ; 80x30 chars @ 640x480x256
-  je         SetKnownModeLegacy2
-  DebugLog   StrUnknownMode
-  jmp        Hang
-SetKnownModeLegacy1:
+  cmp        al, 0x07
+  ja         SetModeLegacyGraphics
+  cmp        al, 0x06
+  je         SetModeLegacyCga
   mov        al, 0x30     ; return success value
   jmp        SetModeLegacyDone
-SetKnownModeLegacy2:
+SetModeLegacyCga:
+  mov        al, 0x3f     ; return success value
+  jmp        SetModeLegacyDone
+SetModeLegacyGraphics:
   mov        al, 0x20     ; return success value
 SetModeLegacyDone:
   DebugLog   StrExitSuccess
   iret
 
 
+GetModeLegacy:
+  ; Inputs:
+  ;   AH    = 0x0f
+  ; Outputs:
+  ;   AH    = number of character columns
+  ;   AL    = video mode
+  ;   BH    = active page
+  DebugLog   StrEnterGetModeLegacy
+
+  mov        ax, 0x5003   ; 80 columns, mode 0x03
+  xor        bh, bh
+  iret
+
+
+GetEgaInfoLegacy:
+  ; Inputs:
+  ;   AH    = 0x12
+  ;   BL    = 0x10 (get EGA info), other subfunctions are ignored
+  ; Outputs:
+  ;   BH    = 0 for color mode
+  ;   BL    = 3 for 256 KiB of video memory
+  ;   CH    = feature bits
+  ;   CL    = switch settings
+  cmp        bl, 0x10
+  jne        UnknownLegacy
+
+  DebugLog   StrEnterGetEgaInfoLegacy
+
+  mov        bx, 0x0003
+  mov        cx, 0x0009
+  iret
+
+
+GetDisplayCombinationLegacy:
+  ; Inputs:
+  ;   AX    = 0x1a00
+  ; Outputs:
+  ;   AL    = 0x1a if function is supported
+  ;   BL    = active display code, 8 for VGA with color display
+  ;   BH    = alternate display code, 0 for none
+  cmp        al, 0x00
+  jne        UnknownLegacy
+
+  DebugLog   StrEnterGetDisplayCombinationLegacy
+
+  mov        al, 0x1a
+  mov        bx, 0x0008
+  iret
+
+
+UnknownLegacy:
+  ; Cursor, palette, teletype output and the rest of the legacy functions
+  ; have no visible effect on a linear framebuffer, so return them with
+  ; all registers unchanged.
+  DebugLog   StrUnknownFunction
+  iret
+
+
 Success:
   DebugLog   StrExitSuccess
   mov        ax, 0x004f
@@ -258,55 +447,150 @@ Unsupported:
   iret
 
 
-%ifdef DEBUG
-SerialPrint:
-  pusha
-  push       ds ; save original
-  push       cs
-  pop        ds
-
-  mov dx, 03F8h + 01h        ;Disable all interrupts
-  mov al, 0000_0000b
-  out dx,al
+NotSupported:
+  ; VBE function that exists but is not supported by the hardware, e.g.
+  ; palette and window control with a direct color linear framebuffer
+  DebugLog   StrUnknownFunction
+  mov        ax, 0x024f
+  iret
 
-  mov dx, 03F8h + 03h        ;Enable DLAB
-  mov al, 1000_0000b
-  out dx,al
 
-  mov dx, 03F8h + 00h        ;Set divisor to 1 (lo byte) 115200 baud
-  mov al, 0000_0001b
-  out dx,al
+VbeFunctions:
+  dw         GetInfo      ; 4f00
+  dw         GetModeInfo  ; 4f01
+  dw         SetMode      ; 4f02
+  dw         GetMode      ; 4f03
+  dw         NotSupported ; 4f04 save/restore state
+  dw         NotSupported ; 4f05 display window control
+  dw         NotSupported ; 4f06 logical scan line length
+  dw         NotSupported ; 4f07 display start
+  dw         NotSupported ; 4f08 DAC palette format
+  dw         NotSupported ; 4f09 palette data
+  dw         NotSupported ; 4f0a protected mode interface
+  dw         NotSupported ; 4f0b pixel clock
+  dw         NotSupported ; 4f0c
+  dw         NotSupported ; 4f0d
+  dw         NotSupported ; 4f0e
+  dw         NotSupported ; 4f0f
+  dw         GetPmCapabilities ; 4f10
+  dw         NotSupported ; 4f11 flat panel
+  dw         NotSupported ; 4f12
+  dw         NotSupported ; 4f13 audio
+  dw         NotSupported ; 4f14 OEM
+  dw         ReadEdid     ; 4f15
+
+
+LegacyFunctions:
+  dw         SetModeLegacy ; 00
+  dw         UnknownLegacy ; 01 set cursor shape
+  dw         UnknownLegacy ; 02 set cursor position
+  dw         UnknownLegacy ; 03 get cursor position
+  dw         UnknownLegacy ; 04
+  dw         UnknownLegacy ; 05 select active page
+  dw         UnknownLegacy ; 06 scroll up
+  dw         UnknownLegacy ; 07 scroll down
+  dw         UnknownLegacy ; 08 read character
+  dw         UnknownLegacy ; 09 write character and attribute
+  dw         UnknownLegacy ; 0a write character
+  dw         UnknownLegacy ; 0b set border color
+  dw         UnknownLegacy ; 0c write pixel
+  dw         UnknownLegacy ; 0d read pixel
+  dw         UnknownLegacy ; 0e teletype output
+  dw         GetModeLegacy ; 0f
+  dw         UnknownLegacy ; 10 palette registers
+  dw         UnknownLegacy ; 11 character generator
+  dw         GetEgaInfoLegacy ; 12
+  dw         UnknownLegacy ; 13 write string
+  dw         UnknownLegacy ; 14
+  dw         UnknownLegacy ; 15
+  dw         UnknownLegacy ; 16
+  dw         UnknownLegacy ; 17
+  dw         UnknownLegacy ; 18
+  dw         UnknownLegacy ; 19
+  dw         GetDisplayCombinationLegacy ; 1a
+  dw         UnknownLegacy ; 1b functionality state
+  dw         UnknownLegacy ; 1c save/restore state
+  dw         UnknownLegacy ; 1d
+  dw         UnknownLegacy ; 1e
+  dw         UnknownLegacy ; 1f
+
+
+%ifdef TRACE
+TraceEnter:
+  ; Records AX, BX, CX and DX on entry in the next entry of the trace
+  ; ring and remembers the entry for TraceLeave. Every entry is 16 bytes,
+  ; the registers on entry followed by the same registers on return.
+  push       di
+  cmp        word [cs:ShimTraceEntries], 0
+  je         TraceEnterDone
+
+  mov        di, [cs:ShimTraceHead]
+  shl        di, 4
+  add        di, [cs:ShimTraceOffset]
+  mov        [cs:ShimTraceSlot], di
+  mov        [cs:di], ax
+  mov        [cs:di + 2], bx
+  mov        [cs:di + 4], cx
+  mov        [cs:di + 6], dx
+  mov        word [cs:di + 8], 0 ; no result yet, in case the call never returns
+  mov        word [cs:di + 10], 0
+  mov        word [cs:di + 12], 0
+  mov        word [cs:di + 14], 0
+
+  inc        word [cs:ShimTraceHead]
+  mov        di, [cs:ShimTraceHead]
+  cmp        di, [cs:ShimTraceEntries]
+  jb         TraceEnterCount
+  mov        word [cs:ShimTraceHead], 0 ; wrap around, overwriting the oldest calls
+TraceEnterCount:
+  add        word [cs:ShimTraceCalls], 1
+  adc        word [cs:ShimTraceCalls + 2], 0
+TraceEnterDone:
+  pop        di
+  ret
 
-  mov dx, 03F8h + 01h        ;(hi byte)
-  mov al, 0000_0000b
-  out dx,al
 
-  mov dx, 03F8h + 03h        ; 8 bits, no parity, one stop bit
-  mov al, 0000_0011b
-  out dx,al
+TraceLeave:
+  ; Records AX, BX, CX and DX on return in the entry of TraceEnter.
+  push       di
+  cmp        word [cs:ShimTraceEntries], 0
+  je         TraceLeaveDone
+
+  mov        di, [cs:ShimTraceSlot]
+  mov        [cs:di + 8], ax
+  mov        [cs:di + 10], bx
+  mov        [cs:di + 12], cx
+  mov        [cs:di + 14], dx
+TraceLeaveDone:
+  pop        di
+  iret
+%endif
 
-  mov dx, 03F8h + 02h        ; Enable FIFO, clear them, with 14-byte threshold
-  mov al, 1100_0111b
-  out dx,al
 
-  mov dx, 03F8h + 04h        ; IRQs enabled, RTS/DSR set
-  mov al, 0000_1011b
-  out dx,al
+%ifdef DEBUG
+SerialPrint:
+  pusha
+  push       ds ; save original
+  push       cs
+  pop        ds
 
-  mov dx, 03F8h + 03h         ;Line Control Register: 0x3F8 + 0x3
-  in al, dx
-  and al, 0111_1111b   ;Set DLAB=0
-  out dx,al
+  cmp        word [ShimSerialPort], 0
+  je         SerialPrintDone
+  cmp        byte [ShimSerialReady], 0
+  jne        SerialPrintStart
+  call       SerialInit
 
+SerialPrintStart:
+  mov        bx, [ShimSerialPort]
 SerialPrintLoop:
-  mov dx, 03F8h + 05h       ;Line Status Register: 0x3F8 + 0x5
-  in al, dx
-  test al, 0010_0000b  ;Use bit 5 to see if THR is empty
-  jz SerialPrintLoop
+  lea        dx, [bx + 05h] ; Line Status Register
+  in         al, dx
+  test       al, 0010_0000b ; Use bit 5 to see if THR is empty
+  jz         SerialPrintLoop
   lodsb
   cmp        al, 0
   je         SerialPrintDone
-  mov        dx, 03F8h ; COM1
+  mov        dx, bx       ; Transmit Holding Register
   out        dx, al
   jmp        SerialPrintLoop
 SerialPrintDone:
@@ -315,6 +599,43 @@ SerialPrintDone:
   ret
 
 
+SerialInit:
+  ; Programs the UART unless UefiSeven has already done so. The flag
+  ; only sticks while the shim memory is writable, a locked shim gets
+  ; here on every call.
+  mov        bx, [ShimSerialPort]
+
+  lea        dx, [bx + 01h] ; Disable all interrupts
+  mov        al, 0000_0000b
+  out        dx, al
+
+  lea        dx, [bx + 03h] ; Enable DLAB
+  mov        al, 1000_0000b
+  out        dx, al
+
+  mov        ax, [ShimSerialDivisor]
+  mov        dx, bx       ; Set divisor (lo byte)
+  out        dx, al
+  inc        dx           ; (hi byte)
+  mov        al, ah
+  out        dx, al
+
+  lea        dx, [bx + 03h] ; 8 bits, no parity, one stop bit, DLAB=0
+  mov        al, 0000_0011b
+  out        dx, al
+
+  lea        dx, [bx + 02h] ; Enable FIFO, clear them, with 14-byte threshold
+  mov        al, 1100_0111b
+  out        dx, al
+
+  lea        dx, [bx + 04h] ; IRQs enabled, RTS/DSR set
+  mov        al, 0000_1011b
+  out        dx, al
+
+  mov        byte [ShimSerialReady], 1
+  ret
+
+
 StrExitSuccess:
   db 'Exit', 0x0a, 0
 
@@ -339,6 +660,15 @@ StrEnterSetMode:
 StrEnterSetModeLegacy:
   db 'SetModeLegacy', 0x0a, 0
 
+StrEnterGetModeLegacy:
+  db 'GetModeLegacy', 0x0a, 0
+
+StrEnterGetEgaInfoLegacy:
+  db 'GetEgaInfoLegacy', 0x0a, 0
+
+StrEnterGetDisplayCombinationLegacy:
+  db 'GetDisplayCombinationLegacy', 0x0a, 0
+
 StrUnknownMode:
   db 'Unknown Mode', 0x0a, 0
 
@@ -517,83 +517,1215 @@ STATIC CONST UINT8 INT10H_HANDLER[] = {
   /* 000001FD nop                            */  0x90,
   /* 000001FE nop                            */  0x90,
   /* 000001FF nop                            */  0x90,
-  /* 00000200 cmp ax,0x4f00                  */  0x3D, 0x00, 0x4F,
-  /* 00000203 jz 0x225                       */  0x74, 0x20,
-  /* 00000205 cmp ax,0x4f01                  */  0x3D, 0x01, 0x4F,
-  /* 00000208 jz 0x23c                       */  0x74, 0x32,
-  /* 0000020A cmp ax,0x4f02                  */  0x3D, 0x02, 0x4F,
-  /* 0000020D jz 0x25f                       */  0x74, 0x50,
-  /* 0000020F cmp ax,0x4f03                  */  0x3D, 0x03, 0x4F,
-  /* 00000212 jz 0x26d                       */  0x74, 0x59,
-  /* 00000214 cmp ax,0x4f10                  */  0x3D, 0x10, 0x4F,
-  /* 00000217 jz 0x272                       */  0x74, 0x59,
-  /* 00000219 cmp ax,0x4f15                  */  0x3D, 0x15, 0x4F,
-  /* 0000021C jz 0x274                       */  0x74, 0x56,
-  /* 0000021E cmp ah,0x0                     */  0x80, 0xFC, 0x00,
-  /* 00000221 jz 0x276                       */  0x74, 0x53,
-  /* 00000223 jmp short 0x223                */  0xEB, 0xFE,
-  /* 00000225 push es                        */  0x06,
-  /* 00000226 push di                        */  0x57,
-  /* 00000227 push ds                        */  0x1E,
-  /* 00000228 push si                        */  0x56,
-  /* 00000229 push cx                        */  0x51,
-  /* 0000022A push cs                        */  0x0E,
-  /* 0000022B pop ds                         */  0x1F,
-  /* 0000022C mov si,0x0                     */  0xBE, 0x00, 0x00,
-  /* 0000022F mov cx,0x100                   */  0xB9, 0x00, 0x01,
-  /* 00000232 cld                            */  0xFC,
-  /* 00000233 rep movsb                      */  0xF3, 0xA4,
-  /* 00000235 pop cx                         */  0x59,
-  /* 00000236 pop si                         */  0x5E,
-  /* 00000237 pop ds                         */  0x1F,
-  /* 00000238 pop di                         */  0x5F,
-  /* 00000239 pop es                         */  0x07,
-  /* 0000023A jmp short 0x287                */  0xEB, 0x4B,
-  /* 0000023C push es                        */  0x06,
-  /* 0000023D push di                        */  0x57,
-  /* 0000023E push ds                        */  0x1E,
-  /* 0000023F push si                        */  0x56,
-  /* 00000240 push cx                        */  0x51,
-  /* 00000241 and cx,0xbfff                  */  0x81, 0xE1, 0xFF, 0xBF,
-  /* 00000245 cmp cx,0xf1                    */  0x81, 0xF9, 0xF1, 0x00,
-  /* 00000249 jz 0x24d                       */  0x74, 0x02,
-  /* 0000024B jmp short 0x223                */  0xEB, 0xD6,
-  /* 0000024D push cs                        */  0x0E,
-  /* 0000024E pop ds                         */  0x1F,
-  /* 0000024F mov si,0x100                   */  0xBE, 0x00, 0x01,
-  /* 00000252 mov cx,0x100                   */  0xB9, 0x00, 0x01,
-  /* 00000255 cld                            */  0xFC,
-  /* 00000256 rep movsb                      */  0xF3, 0xA4,
-  /* 00000258 pop cx                         */  0x59,
-  /* 00000259 pop si                         */  0x5E,
-  /* 0000025A pop ds                         */  0x1F,
-  /* 0000025B pop di                         */  0x5F,
-  /* 0000025C pop es                         */  0x07,
-  /* 0000025D jmp short 0x287                */  0xEB, 0x28,
-  /* 0000025F push dx                        */  0x52,
-  /* 00000260 push ax                        */  0x50,
-  /* 00000261 cmp bx,0x40f1                  */  0x81, 0xFB, 0xF1, 0x40,
-  /* 00000265 jz 0x269                       */  0x74, 0x02,
-  /* 00000267 jmp short 0x223                */  0xEB, 0xBA,
-  /* 00000269 pop ax                         */  0x58,
-  /* 0000026A pop dx                         */  0x5A,
-  /* 0000026B jmp short 0x287                */  0xEB, 0x1A,
-  /* 0000026D mov bx,0x40f1                  */  0xBB, 0xF1, 0x40,
-  /* 00000270 jmp short 0x287                */  0xEB, 0x15,
-  /* 00000272 jmp short 0x28b                */  0xEB, 0x17,
-  /* 00000274 jmp short 0x28b                */  0xEB, 0x15,
-  /* 00000276 cmp al,0x3                     */  0x3C, 0x03,
-  /* 00000278 jz 0x280                       */  0x74, 0x06,
-  /* 0000027A cmp al,0x12                    */  0x3C, 0x12,
-  /* 0000027C jz 0x284                       */  0x74, 0x06,
-  /* 0000027E jmp short 0x223                */  0xEB, 0xA3,
-  /* 00000280 mov al,0x30                    */  0xB0, 0x30,
-  /* 00000282 jmp short 0x286                */  0xEB, 0x02,
-  /* 00000284 mov al,0x20                    */  0xB0, 0x20,
-  /* 00000286 iretw                          */  0xCF,
-  /* 00000287 mov ax,0x4f                    */  0xB8, 0x4F, 0x00,
-  /* 0000028A iretw                          */  0xCF,
-  /* 0000028B mov ax,0x14f                   */  0xB8, 0x4F, 0x01,
-  /* 0000028E iretw                          */  0xCF,
+  /* 00000200 push bx                        */  0x53,
+  /* 00000201 push bx                        */  0x53,
+  /* 00000202 push bp                        */  0x55,
+  /* 00000203 mov bp,sp                      */  0x89, 0xE5,
+  /* 00000205 cmp ah,0x4f                    */  0x80, 0xFC, 0x4F,
+  /* 00000208 jz 0x21f                       */  0x74, 0x15,
+  /* 0000020A cmp ah,0x20                    */  0x80, 0xFC, 0x20,
+  /* 0000020D jc 0x24b                       */  0x72, 0x3C,
+  /* 0000020F push ds                        */  0x1E,
+  /* 00000210 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 00000215 inc word [ds:0x176]            */  0xFF, 0x06, 0x76, 0x01,
+  /* 00000219 pop ds                         */  0x1F,
+  /* 0000021A mov bx,0x35c                   */  0xBB, 0x5C, 0x03,
+  /* 0000021D jmp short 0x261                */  0xEB, 0x42,
+  /* 0000021F cmp al,0x16                    */  0x3C, 0x16,
+  /* 00000221 jc 0x233                       */  0x72, 0x10,
+  /* 00000223 push ds                        */  0x1E,
+  /* 00000224 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 00000229 inc word [ds:0x176]            */  0xFF, 0x06, 0x76, 0x01,
+  /* 0000022D pop ds                         */  0x1F,
+  /* 0000022E mov bx,0x361                   */  0xBB, 0x61, 0x03,
+  /* 00000231 jmp short 0x261                */  0xEB, 0x2E,
+  /* 00000233 mov bl,al                      */  0x88, 0xC3,
+  /* 00000235 xor bh,bh                      */  0x30, 0xFF,
+  /* 00000237 shl bx,1                       */  0xD1, 0xE3,
+  /* 00000239 push ds                        */  0x1E,
+  /* 0000023A mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 0000023F inc word [bx+0x10a]            */  0xFF, 0x87, 0x0A, 0x01,
+  /* 00000243 pop ds                         */  0x1F,
+  /* 00000244 mov bx,word [cs:bx+0x369]      */  0x2E, 0x8B, 0x9F, 0x69, 0x03,
+  /* 00000249 jmp short 0x261                */  0xEB, 0x16,
+  /* 0000024B mov bl,ah                      */  0x88, 0xE3,
+  /* 0000024D xor bh,bh                      */  0x30, 0xFF,
+  /* 0000024F shl bx,1                       */  0xD1, 0xE3,
+  /* 00000251 push ds                        */  0x1E,
+  /* 00000252 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 00000257 inc word [bx+0x136]            */  0xFF, 0x87, 0x36, 0x01,
+  /* 0000025B pop ds                         */  0x1F,
+  /* 0000025C mov bx,word [cs:bx+0x395]      */  0x2E, 0x8B, 0x9F, 0x95, 0x03,
+  /* 00000261 mov word [bp+0x2],bx           */  0x89, 0x5E, 0x02,
+  /* 00000264 mov bx,word [bp+0x4]           */  0x8B, 0x5E, 0x04,
+  /* 00000267 pop bp                         */  0x5D,
+  /* 00000268 ret 0x2                        */  0xC2, 0x02, 0x00,
+  /* 0000026B push es                        */  0x06,
+  /* 0000026C push di                        */  0x57,
+  /* 0000026D push ds                        */  0x1E,
+  /* 0000026E push si                        */  0x56,
+  /* 0000026F push cx                        */  0x51,
+  /* 00000270 push cs                        */  0x0E,
+  /* 00000271 pop ds                         */  0x1F,
+  /* 00000272 mov si,0x0                     */  0xBE, 0x00, 0x00,
+  /* 00000275 mov cx,0x100                   */  0xB9, 0x00, 0x01,
+  /* 00000278 cld                            */  0xFC,
+  /* 00000279 rep movsb                      */  0xF3, 0xA4,
+  /* 0000027B pop cx                         */  0x59,
+  /* 0000027C pop si                         */  0x5E,
+  /* 0000027D pop ds                         */  0x1F,
+  /* 0000027E pop di                         */  0x5F,
+  /* 0000027F pop es                         */  0x07,
+  /* 00000280 jmp 0x35d                      */  0xE9, 0xDA, 0x00,
+  /* 00000283 push cx                        */  0x51,
+  /* 00000284 and cx,0x1ff                   */  0x81, 0xE1, 0xFF, 0x01,
+  /* 00000288 sub cx,0xf1                    */  0x81, 0xE9, 0xF1, 0x00,
+  /* 0000028C cmp cx,word [cs:0x104]         */  0x2E, 0x3B, 0x0E, 0x04, 0x01,
+  /* 00000291 jc 0x297                       */  0x72, 0x04,
+  /* 00000293 pop cx                         */  0x59,
+  /* 00000294 jmp 0x361                      */  0xE9, 0xCA, 0x00,
+  /* 00000297 push es                        */  0x06,
+  /* 00000298 push di                        */  0x57,
+  /* 00000299 push ds                        */  0x1E,
+  /* 0000029A push si                        */  0x56,
+  /* 0000029B push cs                        */  0x0E,
+  /* 0000029C pop ds                         */  0x1F,
+  /* 0000029D mov si,cx                      */  0x89, 0xCE,
+  /* 0000029F shl si,0x8                     */  0xC1, 0xE6, 0x08,
+  /* 000002A2 add si,word [ds:0x106]         */  0x03, 0x36, 0x06, 0x01,
+  /* 000002A6 mov cx,0x100                   */  0xB9, 0x00, 0x01,
+  /* 000002A9 cld                            */  0xFC,
+  /* 000002AA rep movsb                      */  0xF3, 0xA4,
+  /* 000002AC pop si                         */  0x5E,
+  /* 000002AD pop ds                         */  0x1F,
+  /* 000002AE pop di                         */  0x5F,
+  /* 000002AF pop es                         */  0x07,
+  /* 000002B0 pop cx                         */  0x59,
+  /* 000002B1 jmp 0x35d                      */  0xE9, 0xA9, 0x00,
+  /* 000002B4 push dx                        */  0x52,
+  /* 000002B5 push ax                        */  0x50,
+  /* 000002B6 test bx,0x4000                 */  0xF7, 0xC3, 0x00, 0x40,
+  /* 000002BA jz 0x2cb                       */  0x74, 0x0F,
+  /* 000002BC mov ax,bx                      */  0x89, 0xD8,
+  /* 000002BE and ax,0x1ff                   */  0x25, 0xFF, 0x01,
+  /* 000002C1 sub ax,0xf1                    */  0x2D, 0xF1, 0x00,
+  /* 000002C4 cmp ax,word [cs:0x104]         */  0x2E, 0x3B, 0x06, 0x04, 0x01,
+  /* 000002C9 jc 0x2d0                       */  0x72, 0x05,
+  /* 000002CB pop ax                         */  0x58,
+  /* 000002CC pop dx                         */  0x5A,
+  /* 000002CD jmp 0x361                      */  0xE9, 0x91, 0x00,
+  /* 000002D0 push ds                        */  0x1E,
+  /* 000002D1 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 000002D6 mov ax,bx                      */  0x89, 0xD8,
+  /* 000002D8 and ax,0x41ff                  */  0x25, 0xFF, 0x41,
+  /* 000002DB mov [ds:0x108],ax              */  0xA3, 0x08, 0x01,
+  /* 000002DE pop ds                         */  0x1F,
+  /* 000002DF pop ax                         */  0x58,
+  /* 000002E0 pop dx                         */  0x5A,
+  /* 000002E1 jmp short 0x35d                */  0xEB, 0x7A,
+  /* 000002E3 push ds                        */  0x1E,
+  /* 000002E4 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 000002E9 mov bx,word [ds:0x108]         */  0x8B, 0x1E, 0x08, 0x01,
+  /* 000002ED pop ds                         */  0x1F,
+  /* 000002EE jmp short 0x35d                */  0xEB, 0x6D,
+  /* 000002F0 jmp short 0x361                */  0xEB, 0x6F,
+  /* 000002F2 cmp word [cs:0x18b],0x0        */  0x2E, 0x83, 0x3E, 0x8B, 0x01, 0x00,
+  /* 000002F8 jz 0x304                       */  0x74, 0x0A,
+  /* 000002FA cmp bl,0x0                     */  0x80, 0xFB, 0x00,
+  /* 000002FD jz 0x306                       */  0x74, 0x07,
+  /* 000002FF cmp bl,0x1                     */  0x80, 0xFB, 0x01,
+  /* 00000302 jz 0x30b                       */  0x74, 0x07,
+  /* 00000304 jmp short 0x361                */  0xEB, 0x5B,
+  /* 00000306 mov bx,0x2                     */  0xBB, 0x02, 0x00,
+  /* 00000309 jmp short 0x35d                */  0xEB, 0x52,
+  /* 0000030B cmp dx,word [cs:0x18b]         */  0x2E, 0x3B, 0x16, 0x8B, 0x01,
+  /* 00000310 jnc 0x304                      */  0x73, 0xF2,
+  /* 00000312 push di                        */  0x57,
+  /* 00000313 push ds                        */  0x1E,
+  /* 00000314 push si                        */  0x56,
+  /* 00000315 push cx                        */  0x51,
+  /* 00000316 push cs                        */  0x0E,
+  /* 00000317 pop ds                         */  0x1F,
+  /* 00000318 mov si,dx                      */  0x89, 0xD6,
+  /* 0000031A shl si,0x7                     */  0xC1, 0xE6, 0x07,
+  /* 0000031D add si,word [ds:0x189]         */  0x03, 0x36, 0x89, 0x01,
+  /* 00000321 mov cx,0x80                    */  0xB9, 0x80, 0x00,
+  /* 00000324 cld                            */  0xFC,
+  /* 00000325 rep movsb                      */  0xF3, 0xA4,
+  /* 00000327 pop cx                         */  0x59,
+  /* 00000328 pop si                         */  0x5E,
+  /* 00000329 pop ds                         */  0x1F,
+  /* 0000032A pop di                         */  0x5F,
+  /* 0000032B jmp short 0x35d                */  0xEB, 0x30,
+  /* 0000032D cmp al,0x7                     */  0x3C, 0x07,
+  /* 0000032F ja 0x33d                       */  0x77, 0x0C,
+  /* 00000331 cmp al,0x6                     */  0x3C, 0x06,
+  /* 00000333 jz 0x339                       */  0x74, 0x04,
+  /* 00000335 mov al,0x30                    */  0xB0, 0x30,
+  /* 00000337 jmp short 0x33f                */  0xEB, 0x06,
+  /* 00000339 mov al,0x3f                    */  0xB0, 0x3F,
+  /* 0000033B jmp short 0x33f                */  0xEB, 0x02,
+  /* 0000033D mov al,0x20                    */  0xB0, 0x20,
+  /* 0000033F iretw                          */  0xCF,
+  /* 00000340 mov ax,0x5003                  */  0xB8, 0x03, 0x50,
+  /* 00000343 xor bh,bh                      */  0x30, 0xFF,
+  /* 00000345 iretw                          */  0xCF,
+  /* 00000346 cmp bl,0x10                    */  0x80, 0xFB, 0x10,
+  /* 00000349 jnz 0x35c                      */  0x75, 0x11,
+  /* 0000034B mov bx,0x3                     */  0xBB, 0x03, 0x00,
+  /* 0000034E mov cx,0x9                     */  0xB9, 0x09, 0x00,
+  /* 00000351 iretw                          */  0xCF,
+  /* 00000352 cmp al,0x0                     */  0x3C, 0x00,
+  /* 00000354 jnz 0x35c                      */  0x75, 0x06,
+  /* 00000356 mov al,0x1a                    */  0xB0, 0x1A,
+  /* 00000358 mov bx,0x8                     */  0xBB, 0x08, 0x00,
+  /* 0000035B iretw                          */  0xCF,
+  /* 0000035C iretw                          */  0xCF,
+  /* 0000035D mov ax,0x4f                    */  0xB8, 0x4F, 0x00,
+  /* 00000360 iretw                          */  0xCF,
+  /* 00000361 mov ax,0x14f                   */  0xB8, 0x4F, 0x01,
+  /* 00000364 iretw                          */  0xCF,
+  /* 00000365 mov ax,0x24f                   */  0xB8, 0x4F, 0x02,
+  /* 00000368 iretw                          */  0xCF,
+  /* 00000369 imul ax,word [bp+si],0xff83    */  0x6B, 0x02, 0x83,
+  /* 0000036C add dh,byte [si-0x1cfe]        */  0x02, 0xB4, 0x02, 0xE3,
+  /* 00000370 add ah,byte [di+0x3]           */  0x02, 0x65, 0x03,
+  /* 00000373 add sp,word gs:[di+0x3]        */  0x65, 0x03, 0x65, 0x03,
+  /* 00000377 add sp,word gs:[di+0x3]        */  0x65, 0x03, 0x65, 0x03,
+  /* 0000037B add sp,word gs:[di+0x3]        */  0x65, 0x03, 0x65, 0x03,
+  /* 0000037F add sp,word gs:[di+0x3]        */  0x65, 0x03, 0x65, 0x03,
+  /* 00000383 add sp,word gs:[di+0x3]        */  0x65, 0x03, 0x65, 0x03,
+  /* 00000387 gs add si,ax                   */  0x65, 0x03, 0xF0,
+  /* 0000038A add ah,byte [di+0x3]           */  0x02, 0x65, 0x03,
+  /* 0000038D add sp,word gs:[di+0x3]        */  0x65, 0x03, 0x65, 0x03,
+  /* 00000391 gs add si,dx                   */  0x65, 0x03, 0xF2,
+  /* 00000394 add ch,byte [di]               */  0x02, 0x2D,
+  /* 00000396 add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 00000399 pop sp                         */  0x5C,
+  /* 0000039A add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 0000039D pop sp                         */  0x5C,
+  /* 0000039E add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003A1 pop sp                         */  0x5C,
+  /* 000003A2 add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003A5 pop sp                         */  0x5C,
+  /* 000003A6 add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003A9 pop sp                         */  0x5C,
+  /* 000003AA add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003AD pop sp                         */  0x5C,
+  /* 000003AE add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003B1 pop sp                         */  0x5C,
+  /* 000003B2 add ax,word [bx+si+0x3]        */  0x03, 0x40, 0x03,
+  /* 000003B5 pop sp                         */  0x5C,
+  /* 000003B6 add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003B9 inc si                         */  0x46,
+  /* 000003BA add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003BD pop sp                         */  0x5C,
+  /* 000003BE add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003C1 pop sp                         */  0x5C,
+  /* 000003C2 add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003C5 pop sp                         */  0x5C,
+  /* 000003C6 add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003C9 push dx                        */  0x52,
+  /* 000003CA add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003CD pop sp                         */  0x5C,
+  /* 000003CE add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+  /* 000003D1 pop sp                         */  0x5C,
+  /* 000003D2 add bx,word [si+0x3]           */  0x03, 0x5C, 0x03,
+};
+STATIC CONST UINT8 INT10H_HANDLER_TRACE[] = {
+  /* 00000000 nop                            */  0x90,
+  /* 00000001 nop                            */  0x90,
+  /* 00000002 nop                            */  0x90,
+  /* 00000003 nop                            */  0x90,
+  /* 00000004 nop                            */  0x90,
+  /* 00000005 nop                            */  0x90,
+  /* 00000006 nop                            */  0x90,
+  /* 00000007 nop                            */  0x90,
+  /* 00000008 nop                            */  0x90,
+  /* 00000009 nop                            */  0x90,
+  /* 0000000A nop                            */  0x90,
+  /* 0000000B nop                            */  0x90,
+  /* 0000000C nop                            */  0x90,
+  /* 0000000D nop                            */  0x90,
+  /* 0000000E nop                            */  0x90,
+  /* 0000000F nop                            */  0x90,
+  /* 00000010 nop                            */  0x90,
+  /* 00000011 nop                            */  0x90,
+  /* 00000012 nop                            */  0x90,
+  /* 00000013 nop                            */  0x90,
+  /* 00000014 nop                            */  0x90,
+  /* 00000015 nop                            */  0x90,
+  /* 00000016 nop                            */  0x90,
+  /* 00000017 nop                            */  0x90,
+  /* 00000018 nop                            */  0x90,
+  /* 00000019 nop                            */  0x90,
+  /* 0000001A nop                            */  0x90,
+  /* 0000001B nop                            */  0x90,
+  /* 0000001C nop                            */  0x90,
+  /* 0000001D nop                            */  0x90,
+  /* 0000001E nop                            */  0x90,
+  /* 0000001F nop                            */  0x90,
+  /* 00000020 nop                            */  0x90,
+  /* 00000021 nop                            */  0x90,
+  /* 00000022 nop                            */  0x90,
+  /* 00000023 nop                            */  0x90,
+  /* 00000024 nop                            */  0x90,
+  /* 00000025 nop                            */  0x90,
+  /* 00000026 nop                            */  0x90,
+  /* 00000027 nop                            */  0x90,
+  /* 00000028 nop                            */  0x90,
+  /* 00000029 nop                            */  0x90,
+  /* 0000002A nop                            */  0x90,
+  /* 0000002B nop                            */  0x90,
+  /* 0000002C nop                            */  0x90,
+  /* 0000002D nop                            */  0x90,
+  /* 0000002E nop                            */  0x90,
+  /* 0000002F nop                            */  0x90,
+  /* 00000030 nop                            */  0x90,
+  /* 00000031 nop                            */  0x90,
+  /* 00000032 nop                            */  0x90,
+  /* 00000033 nop                            */  0x90,
+  /* 00000034 nop                            */  0x90,
+  /* 00000035 nop                            */  0x90,
+  /* 00000036 nop                            */  0x90,
+  /* 00000037 nop                            */  0x90,
+  /* 00000038 nop                            */  0x90,
+  /* 00000039 nop                            */  0x90,
+  /* 0000003A nop                            */  0x90,
+  /* 0000003B nop                            */  0x90,
+  /* 0000003C nop                            */  0x90,
+  /* 0000003D nop                            */  0x90,
+  /* 0000003E nop                            */  0x90,
+  /* 0000003F nop                            */  0x90,
+  /* 00000040 nop                            */  0x90,
+  /* 00000041 nop                            */  0x90,
+  /* 00000042 nop                            */  0x90,
+  /* 00000043 nop                            */  0x90,
+  /* 00000044 nop                            */  0x90,
+  /* 00000045 nop                            */  0x90,
+  /* 00000046 nop                            */  0x90,
+  /* 00000047 nop                            */  0x90,
+  /* 00000048 nop                            */  0x90,
+  /* 00000049 nop                            */  0x90,
+  /* 0000004A nop                            */  0x90,
+  /* 0000004B nop                            */  0x90,
+  /* 0000004C nop                            */  0x90,
+  /* 0000004D nop                            */  0x90,
+  /* 0000004E nop                            */  0x90,
+  /* 0000004F nop                            */  0x90,
+  /* 00000050 nop                            */  0x90,
+  /* 00000051 nop                            */  0x90,
+  /* 00000052 nop                            */  0x90,
+  /* 00000053 nop                            */  0x90,
+  /* 00000054 nop                            */  0x90,
+  /* 00000055 nop                            */  0x90,
+  /* 00000056 nop                            */  0x90,
+  /* 00000057 nop                            */  0x90,
+  /* 00000058 nop                            */  0x90,
+  /* 00000059 nop                            */  0x90,
+  /* 0000005A nop                            */  0x90,
+  /* 0000005B nop                            */  0x90,
+  /* 0000005C nop                            */  0x90,
+  /* 0000005D nop                            */  0x90,
+  /* 0000005E nop                            */  0x90,
+  /* 0000005F nop                            */  0x90,
+  /* 00000060 nop                            */  0x90,
+  /* 00000061 nop                            */  0x90,
+  /* 00000062 nop                            */  0x90,
+  /* 00000063 nop                            */  0x90,
+  /* 00000064 nop                            */  0x90,
+  /* 00000065 nop                            */  0x90,
+  /* 00000066 nop                            */  0x90,
+  /* 00000067 nop                            */  0x90,
+  /* 00000068 nop                            */  0x90,
+  /* 00000069 nop                            */  0x90,
+  /* 0000006A nop                            */  0x90,
+  /* 0000006B nop                            */  0x90,
+  /* 0000006C nop                            */  0x90,
+  /* 0000006D nop                            */  0x90,
+  /* 0000006E nop                            */  0x90,
+  /* 0000006F nop                            */  0x90,
+  /* 00000070 nop                            */  0x90,
+  /* 00000071 nop                            */  0x90,
+  /* 00000072 nop                            */  0x90,
+  /* 00000073 nop                            */  0x90,
+  /* 00000074 nop                            */  0x90,
+  /* 00000075 nop                            */  0x90,
+  /* 00000076 nop                            */  0x90,
+  /* 00000077 nop                            */  0x90,
+  /* 00000078 nop                            */  0x90,
+  /* 00000079 nop                            */  0x90,
+  /* 0000007A nop                            */  0x90,
+  /* 0000007B nop                            */  0x90,
+  /* 0000007C nop                            */  0x90,
+  /* 0000007D nop                            */  0x90,
+  /* 0000007E nop                            */  0x90,
+  /* 0000007F nop                            */  0x90,
+  /* 00000080 nop                            */  0x90,
+  /* 00000081 nop                            */  0x90,
+  /* 00000082 nop                            */  0x90,
+  /* 00000083 nop                            */  0x90,
+  /* 00000084 nop                            */  0x90,
+  /* 00000085 nop                            */  0x90,
+  /* 00000086 nop                            */  0x90,
+  /* 00000087 nop                            */  0x90,
+  /* 00000088 nop                            */  0x90,
+  /* 00000089 nop                            */  0x90,
+  /* 0000008A nop                            */  0x90,
+  /* 0000008B nop                            */  0x90,
+  /* 0000008C nop                            */  0x90,
+  /* 0000008D nop                            */  0x90,
+  /* 0000008E nop                            */  0x90,
+  /* 0000008F nop                            */  0x90,
+  /* 00000090 nop                            */  0x90,
+  /* 00000091 nop                            */  0x90,
+  /* 00000092 nop                            */  0x90,
+  /* 00000093 nop                            */  0x90,
+  /* 00000094 nop                            */  0x90,
+  /* 00000095 nop                            */  0x90,
+  /* 00000096 nop                            */  0x90,
+  /* 00000097 nop                            */  0x90,
+  /* 00000098 nop                            */  0x90,
+  /* 00000099 nop                            */  0x90,
+  /* 0000009A nop                            */  0x90,
+  /* 0000009B nop                            */  0x90,
+  /* 0000009C nop                            */  0x90,
+  /* 0000009D nop                            */  0x90,
+  /* 0000009E nop                            */  0x90,
+  /* 0000009F nop                            */  0x90,
+  /* 000000A0 nop                            */  0x90,
+  /* 000000A1 nop                            */  0x90,
+  /* 000000A2 nop                            */  0x90,
+  /* 000000A3 nop                            */  0x90,
+  /* 000000A4 nop                            */  0x90,
+  /* 000000A5 nop                            */  0x90,
+  /* 000000A6 nop                            */  0x90,
+  /* 000000A7 nop                            */  0x90,
+  /* 000000A8 nop                            */  0x90,
+  /* 000000A9 nop                            */  0x90,
+  /* 000000AA nop                            */  0x90,
+  /* 000000AB nop                            */  0x90,
+  /* 000000AC nop                            */  0x90,
+  /* 000000AD nop                            */  0x90,
+  /* 000000AE nop                            */  0x90,
+  /* 000000AF nop                            */  0x90,
+  /* 000000B0 nop                            */  0x90,
+  /* 000000B1 nop                            */  0x90,
+  /* 000000B2 nop                            */  0x90,
+  /* 000000B3 nop                            */  0x90,
+  /* 000000B4 nop                            */  0x90,
+  /* 000000B5 nop                            */  0x90,
+  /* 000000B6 nop                            */  0x90,
+  /* 000000B7 nop                            */  0x90,
+  /* 000000B8 nop                            */  0x90,
+  /* 000000B9 nop                            */  0x90,
+  /* 000000BA nop                            */  0x90,
+  /* 000000BB nop                            */  0x90,
+  /* 000000BC nop                            */  0x90,
+  /* 000000BD nop                            */  0x90,
+  /* 000000BE nop                            */  0x90,
+  /* 000000BF nop                            */  0x90,
+  /* 000000C0 nop                            */  0x90,
+  /* 000000C1 nop                            */  0x90,
+  /* 000000C2 nop                            */  0x90,
+  /* 000000C3 nop                            */  0x90,
+  /* 000000C4 nop                            */  0x90,
+  /* 000000C5 nop                            */  0x90,
+  /* 000000C6 nop                            */  0x90,
+  /* 000000C7 nop                            */  0x90,
+  /* 000000C8 nop                            */  0x90,
+  /* 000000C9 nop                            */  0x90,
+  /* 000000CA nop                            */  0x90,
+  /* 000000CB nop                            */  0x90,
+  /* 000000CC nop                            */  0x90,
+  /* 000000CD nop                            */  0x90,
+  /* 000000CE nop                            */  0x90,
+  /* 000000CF nop                            */  0x90,
+  /* 000000D0 nop                            */  0x90,
+  /* 000000D1 nop                            */  0x90,
+  /* 000000D2 nop                            */  0x90,
+  /* 000000D3 nop                            */  0x90,
+  /* 000000D4 nop                            */  0x90,
+  /* 000000D5 nop                            */  0x90,
+  /* 000000D6 nop                            */  0x90,
+  /* 000000D7 nop                            */  0x90,
+  /* 000000D8 nop                            */  0x90,
+  /* 000000D9 nop                            */  0x90,
+  /* 000000DA nop                            */  0x90,
+  /* 000000DB nop                            */  0x90,
+  /* 000000DC nop                            */  0x90,
+  /* 000000DD nop                            */  0x90,
+  /* 000000DE nop                            */  0x90,
+  /* 000000DF nop                            */  0x90,
+  /* 000000E0 nop                            */  0x90,
+  /* 000000E1 nop                            */  0x90,
+  /* 000000E2 nop                            */  0x90,
+  /* 000000E3 nop                            */  0x90,
+  /* 000000E4 nop                            */  0x90,
+  /* 000000E5 nop                            */  0x90,
+  /* 000000E6 nop                            */  0x90,
+  /* 000000E7 nop                            */  0x90,
+  /* 000000E8 nop                            */  0x90,
+  /* 000000E9 nop                            */  0x90,
+  /* 000000EA nop                            */  0x90,
+  /* 000000EB nop                            */  0x90,
+  /* 000000EC nop                            */  0x90,
+  /* 000000ED nop                            */  0x90,
+  /* 000000EE nop                            */  0x90,
+  /* 000000EF nop                            */  0x90,
+  /* 000000F0 nop                            */  0x90,
+  /* 000000F1 nop                            */  0x90,
+  /* 000000F2 nop                            */  0x90,
+  /* 000000F3 nop                            */  0x90,
+  /* 000000F4 nop                            */  0x90,
+  /* 000000F5 nop                            */  0x90,
+  /* 000000F6 nop                            */  0x90,
+  /* 000000F7 nop                            */  0x90,
+  /* 000000F8 nop                            */  0x90,
+  /* 000000F9 nop                            */  0x90,
+  /* 000000FA nop                            */  0x90,
+  /* 000000FB nop                            */  0x90,
+  /* 000000FC nop                            */  0x90,
+  /* 000000FD nop                            */  0x90,
+  /* 000000FE nop                            */  0x90,
+  /* 000000FF nop                            */  0x90,
+  /* 00000100 nop                            */  0x90,
+  /* 00000101 nop                            */  0x90,
+  /* 00000102 nop                            */  0x90,
+  /* 00000103 nop                            */  0x90,
+  /* 00000104 nop                            */  0x90,
+  /* 00000105 nop                            */  0x90,
+  /* 00000106 nop                            */  0x90,
+  /* 00000107 nop                            */  0x90,
+  /* 00000108 nop                            */  0x90,
+  /* 00000109 nop                            */  0x90,
+  /* 0000010A nop                            */  0x90,
+  /* 0000010B nop                            */  0x90,
+  /* 0000010C nop                            */  0x90,
+  /* 0000010D nop                            */  0x90,
+  /* 0000010E nop                            */  0x90,
+  /* 0000010F nop                            */  0x90,
+  /* 00000110 nop                            */  0x90,
+  /* 00000111 nop                            */  0x90,
+  /* 00000112 nop                            */  0x90,
+  /* 00000113 nop                            */  0x90,
+  /* 00000114 nop                            */  0x90,
+  /* 00000115 nop                            */  0x90,
+  /* 00000116 nop                            */  0x90,
+  /* 00000117 nop                            */  0x90,
+  /* 00000118 nop                            */  0x90,
+  /* 00000119 nop                            */  0x90,
+  /* 0000011A nop                            */  0x90,
+  /* 0000011B nop                            */  0x90,
+  /* 0000011C nop                            */  0x90,
+  /* 0000011D nop                            */  0x90,
+  /* 0000011E nop                            */  0x90,
+  /* 0000011F nop                            */  0x90,
+  /* 00000120 nop                            */  0x90,
+  /* 00000121 nop                            */  0x90,
+  /* 00000122 nop                            */  0x90,
+  /* 00000123 nop                            */  0x90,
+  /* 00000124 nop                            */  0x90,
+  /* 00000125 nop                            */  0x90,
+  /* 00000126 nop                            */  0x90,
+  /* 00000127 nop                            */  0x90,
+  /* 00000128 nop                            */  0x90,
+  /* 00000129 nop                            */  0x90,
+  /* 0000012A nop                            */  0x90,
+  /* 0000012B nop                            */  0x90,
+  /* 0000012C nop                            */  0x90,
+  /* 0000012D nop                            */  0x90,
+  /* 0000012E nop                            */  0x90,
+  /* 0000012F nop                            */  0x90,
+  /* 00000130 nop                            */  0x90,
+  /* 00000131 nop                            */  0x90,
+  /* 00000132 nop                            */  0x90,
+  /* 00000133 nop                            */  0x90,
+  /* 00000134 nop                            */  0x90,
+  /* 00000135 nop                            */  0x90,
+  /* 00000136 nop                            */  0x90,
+  /* 00000137 nop                            */  0x90,
+  /* 00000138 nop                            */  0x90,
+  /* 00000139 nop                            */  0x90,
+  /* 0000013A nop                            */  0x90,
+  /* 0000013B nop                            */  0x90,
+  /* 0000013C nop                            */  0x90,
+  /* 0000013D nop                            */  0x90,
+  /* 0000013E nop                            */  0x90,
+  /* 0000013F nop                            */  0x90,
+  /* 00000140 nop                            */  0x90,
+  /* 00000141 nop                            */  0x90,
+  /* 00000142 nop                            */  0x90,
+  /* 00000143 nop                            */  0x90,
+  /* 00000144 nop                            */  0x90,
+  /* 00000145 nop                            */  0x90,
+  /* 00000146 nop                            */  0x90,
+  /* 00000147 nop                            */  0x90,
+  /* 00000148 nop                            */  0x90,
+  /* 00000149 nop                            */  0x90,
+  /* 0000014A nop                            */  0x90,
+  /* 0000014B nop                            */  0x90,
+  /* 0000014C nop                            */  0x90,
+  /* 0000014D nop                            */  0x90,
+  /* 0000014E nop                            */  0x90,
+  /* 0000014F nop                            */  0x90,
+  /* 00000150 nop                            */  0x90,
+  /* 00000151 nop                            */  0x90,
+  /* 00000152 nop                            */  0x90,
+  /* 00000153 nop                            */  0x90,
+  /* 00000154 nop                            */  0x90,
+  /* 00000155 nop                            */  0x90,
+  /* 00000156 nop                            */  0x90,
+  /* 00000157 nop                            */  0x90,
+  /* 00000158 nop                            */  0x90,
+  /* 00000159 nop                            */  0x90,
+  /* 0000015A nop                            */  0x90,
+  /* 0000015B nop                            */  0x90,
+  /* 0000015C nop                            */  0x90,
+  /* 0000015D nop                            */  0x90,
+  /* 0000015E nop                            */  0x90,
+  /* 0000015F nop                            */  0x90,
+  /* 00000160 nop                            */  0x90,
+  /* 00000161 nop                            */  0x90,
+  /* 00000162 nop                            */  0x90,
+  /* 00000163 nop                            */  0x90,
+  /* 00000164 nop                            */  0x90,
+  /* 00000165 nop                            */  0x90,
+  /* 00000166 nop                            */  0x90,
+  /* 00000167 nop                            */  0x90,
+  /* 00000168 nop                            */  0x90,
+  /* 00000169 nop                            */  0x90,
+  /* 0000016A nop                            */  0x90,
+  /* 0000016B nop                            */  0x90,
+  /* 0000016C nop                            */  0x90,
+  /* 0000016D nop                            */  0x90,
+  /* 0000016E nop                            */  0x90,
+  /* 0000016F nop                            */  0x90,
+  /* 00000170 nop                            */  0x90,
+  /* 00000171 nop                            */  0x90,
+  /* 00000172 nop                            */  0x90,
+  /* 00000173 nop                            */  0x90,
+  /* 00000174 nop                            */  0x90,
+  /* 00000175 nop                            */  0x90,
+  /* 00000176 nop                            */  0x90,
+  /* 00000177 nop                            */  0x90,
+  /* 00000178 nop                            */  0x90,
+  /* 00000179 nop                            */  0x90,
+  /* 0000017A nop                            */  0x90,
+  /* 0000017B nop                            */  0x90,
+  /* 0000017C nop                            */  0x90,
+  /* 0000017D nop                            */  0x90,
+  /* 0000017E nop                            */  0x90,
+  /* 0000017F nop                            */  0x90,
+  /* 00000180 nop                            */  0x90,
+  /* 00000181 nop                            */  0x90,
+  /* 00000182 nop                            */  0x90,
+  /* 00000183 nop                            */  0x90,
+  /* 00000184 nop                            */  0x90,
+  /* 00000185 nop                            */  0x90,
+  /* 00000186 nop                            */  0x90,
+  /* 00000187 nop                            */  0x90,
+  /* 00000188 nop                            */  0x90,
+  /* 00000189 nop                            */  0x90,
+  /* 0000018A nop                            */  0x90,
+  /* 0000018B nop                            */  0x90,
+  /* 0000018C nop                            */  0x90,
+  /* 0000018D nop                            */  0x90,
+  /* 0000018E nop                            */  0x90,
+  /* 0000018F nop                            */  0x90,
+  /* 00000190 nop                            */  0x90,
+  /* 00000191 nop                            */  0x90,
+  /* 00000192 nop                            */  0x90,
+  /* 00000193 nop                            */  0x90,
+  /* 00000194 nop                            */  0x90,
+  /* 00000195 nop                            */  0x90,
+  /* 00000196 nop                            */  0x90,
+  /* 00000197 nop                            */  0x90,
+  /* 00000198 nop                            */  0x90,
+  /* 00000199 nop                            */  0x90,
+  /* 0000019A nop                            */  0x90,
+  /* 0000019B nop                            */  0x90,
+  /* 0000019C nop                            */  0x90,
+  /* 0000019D nop                            */  0x90,
+  /* 0000019E nop                            */  0x90,
+  /* 0000019F nop                            */  0x90,
+  /* 000001A0 nop                            */  0x90,
+  /* 000001A1 nop                            */  0x90,
+  /* 000001A2 nop                            */  0x90,
+  /* 000001A3 nop                            */  0x90,
+  /* 000001A4 nop                            */  0x90,
+  /* 000001A5 nop                            */  0x90,
+  /* 000001A6 nop                            */  0x90,
+  /* 000001A7 nop                            */  0x90,
+  /* 000001A8 nop                            */  0x90,
+  /* 000001A9 nop                            */  0x90,
+  /* 000001AA nop                            */  0x90,
+  /* 000001AB nop                            */  0x90,
+  /* 000001AC nop                            */  0x90,
+  /* 000001AD nop                            */  0x90,
+  /* 000001AE nop                            */  0x90,
+  /* 000001AF nop                            */  0x90,
+  /* 000001B0 nop                            */  0x90,
+  /* 000001B1 nop                            */  0x90,
+  /* 000001B2 nop                            */  0x90,
+  /* 000001B3 nop                            */  0x90,
+  /* 000001B4 nop                            */  0x90,
+  /* 000001B5 nop                            */  0x90,
+  /* 000001B6 nop                            */  0x90,
+  /* 000001B7 nop                            */  0x90,
+  /* 000001B8 nop                            */  0x90,
+  /* 000001B9 nop                            */  0x90,
+  /* 000001BA nop                            */  0x90,
+  /* 000001BB nop                            */  0x90,
+  /* 000001BC nop                            */  0x90,
+  /* 000001BD nop                            */  0x90,
+  /* 000001BE nop                            */  0x90,
+  /* 000001BF nop                            */  0x90,
+  /* 000001C0 nop                            */  0x90,
+  /* 000001C1 nop                            */  0x90,
+  /* 000001C2 nop                            */  0x90,
+  /* 000001C3 nop                            */  0x90,
+  /* 000001C4 nop                            */  0x90,
+  /* 000001C5 nop                            */  0x90,
+  /* 000001C6 nop                            */  0x90,
+  /* 000001C7 nop                            */  0x90,
+  /* 000001C8 nop                            */  0x90,
+  /* 000001C9 nop                            */  0x90,
+  /* 000001CA nop                            */  0x90,
+  /* 000001CB nop                            */  0x90,
+  /* 000001CC nop                            */  0x90,
+  /* 000001CD nop                            */  0x90,
+  /* 000001CE nop                            */  0x90,
+  /* 000001CF nop                            */  0x90,
+  /* 000001D0 nop                            */  0x90,
+  /* 000001D1 nop                            */  0x90,
+  /* 000001D2 nop                            */  0x90,
+  /* 000001D3 nop                            */  0x90,
+  /* 000001D4 nop                            */  0x90,
+  /* 000001D5 nop                            */  0x90,
+  /* 000001D6 nop                            */  0x90,
+  /* 000001D7 nop                            */  0x90,
+  /* 000001D8 nop                            */  0x90,
+  /* 000001D9 nop                            */  0x90,
+  /* 000001DA nop                            */  0x90,
+  /* 000001DB nop                            */  0x90,
+  /* 000001DC nop                            */  0x90,
+  /* 000001DD nop                            */  0x90,
+  /* 000001DE nop                            */  0x90,
+  /* 000001DF nop                            */  0x90,
+  /* 000001E0 nop                            */  0x90,
+  /* 000001E1 nop                            */  0x90,
+  /* 000001E2 nop                            */  0x90,
+  /* 000001E3 nop                            */  0x90,
+  /* 000001E4 nop                            */  0x90,
+  /* 000001E5 nop                            */  0x90,
+  /* 000001E6 nop                            */  0x90,
+  /* 000001E7 nop                            */  0x90,
+  /* 000001E8 nop                            */  0x90,
+  /* 000001E9 nop                            */  0x90,
+  /* 000001EA nop                            */  0x90,
+  /* 000001EB nop                            */  0x90,
+  /* 000001EC nop                            */  0x90,
+  /* 000001ED nop                            */  0x90,
+  /* 000001EE nop                            */  0x90,
+  /* 000001EF nop                            */  0x90,
+  /* 000001F0 nop                            */  0x90,
+  /* 000001F1 nop                            */  0x90,
+  /* 000001F2 nop                            */  0x90,
+  /* 000001F3 nop                            */  0x90,
+  /* 000001F4 nop                            */  0x90,
+  /* 000001F5 nop                            */  0x90,
+  /* 000001F6 nop                            */  0x90,
+  /* 000001F7 nop                            */  0x90,
+  /* 000001F8 nop                            */  0x90,
+  /* 000001F9 nop                            */  0x90,
+  /* 000001FA nop                            */  0x90,
+  /* 000001FB nop                            */  0x90,
+  /* 000001FC nop                            */  0x90,
+  /* 000001FD nop                            */  0x90,
+  /* 000001FE nop                            */  0x90,
+  /* 000001FF nop                            */  0x90,
+  /* 00000200 push si                        */  0x56,
+  /* 00000201 mov si,0x61f                   */  0xBE, 0x1F, 0x06,
+  /* 00000204 call 0x4fa                     */  0xE8, 0xF3, 0x02,
+  /* 00000207 pop si                         */  0x5E,
+  /* 00000208 call 0x472                     */  0xE8, 0x67, 0x02,
+  /* 0000020B pushfw                         */  0x9C,
+  /* 0000020C push cs                        */  0x0E,
+  /* 0000020D push 0x4da                     */  0x68, 0xDA, 0x04,
+  /* 00000210 push bx                        */  0x53,
+  /* 00000211 push bx                        */  0x53,
+  /* 00000212 push bp                        */  0x55,
+  /* 00000213 mov bp,sp                      */  0x89, 0xE5,
+  /* 00000215 cmp ah,0x4f                    */  0x80, 0xFC, 0x4F,
+  /* 00000218 jz 0x22f                       */  0x74, 0x15,
+  /* 0000021A cmp ah,0x20                    */  0x80, 0xFC, 0x20,
+  /* 0000021D jc 0x25b                       */  0x72, 0x3C,
+  /* 0000021F push ds                        */  0x1E,
+  /* 00000220 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 00000225 inc word [ds:0x176]            */  0xFF, 0x06, 0x76, 0x01,
+  /* 00000229 pop ds                         */  0x1F,
+  /* 0000022A mov bx,0x3d9                   */  0xBB, 0xD9, 0x03,
+  /* 0000022D jmp short 0x271                */  0xEB, 0x42,
+  /* 0000022F cmp al,0x16                    */  0x3C, 0x16,
+  /* 00000231 jc 0x243                       */  0x72, 0x10,
+  /* 00000233 push ds                        */  0x1E,
+  /* 00000234 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 00000239 inc word [ds:0x176]            */  0xFF, 0x06, 0x76, 0x01,
+  /* 0000023D pop ds                         */  0x1F,
+  /* 0000023E mov bx,0x3ee                   */  0xBB, 0xEE, 0x03,
+  /* 00000241 jmp short 0x271                */  0xEB, 0x2E,
+  /* 00000243 mov bl,al                      */  0x88, 0xC3,
+  /* 00000245 xor bh,bh                      */  0x30, 0xFF,
+  /* 00000247 shl bx,1                       */  0xD1, 0xE3,
+  /* 00000249 push ds                        */  0x1E,
+  /* 0000024A mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 0000024F inc word [bx+0x10a]            */  0xFF, 0x87, 0x0A, 0x01,
+  /* 00000253 pop ds                         */  0x1F,
+  /* 00000254 mov bx,word [cs:bx+0x406]      */  0x2E, 0x8B, 0x9F, 0x06, 0x04,
+  /* 00000259 jmp short 0x271                */  0xEB, 0x16,
+  /* 0000025B mov bl,ah                      */  0x88, 0xE3,
+  /* 0000025D xor bh,bh                      */  0x30, 0xFF,
+  /* 0000025F shl bx,1                       */  0xD1, 0xE3,
+  /* 00000261 push ds                        */  0x1E,
+  /* 00000262 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 00000267 inc word [bx+0x136]            */  0xFF, 0x87, 0x36, 0x01,
+  /* 0000026B pop ds                         */  0x1F,
+  /* 0000026C mov bx,word [cs:bx+0x432]      */  0x2E, 0x8B, 0x9F, 0x32, 0x04,
+  /* 00000271 mov word [bp+0x2],bx           */  0x89, 0x5E, 0x02,
+  /* 00000274 mov bx,word [bp+0x4]           */  0x8B, 0x5E, 0x04,
+  /* 00000277 pop bp                         */  0x5D,
+  /* 00000278 ret 0x2                        */  0xC2, 0x02, 0x00,
+  /* 0000027B push es                        */  0x06,
+  /* 0000027C push di                        */  0x57,
+  /* 0000027D push ds                        */  0x1E,
+  /* 0000027E push si                        */  0x56,
+  /* 0000027F push cx                        */  0x51,
+  /* 00000280 push si                        */  0x56,
+  /* 00000281 mov si,0x57f                   */  0xBE, 0x7F, 0x05,
+  /* 00000284 call 0x4fa                     */  0xE8, 0x73, 0x02,
+  /* 00000287 pop si                         */  0x5E,
+  /* 00000288 push cs                        */  0x0E,
+  /* 00000289 pop ds                         */  0x1F,
+  /* 0000028A mov si,0x0                     */  0xBE, 0x00, 0x00,
+  /* 0000028D mov cx,0x100                   */  0xB9, 0x00, 0x01,
+  /* 00000290 cld                            */  0xFC,
+  /* 00000291 rep movsb                      */  0xF3, 0xA4,
+  /* 00000293 pop cx                         */  0x59,
+  /* 00000294 pop si                         */  0x5E,
+  /* 00000295 pop ds                         */  0x1F,
+  /* 00000296 pop di                         */  0x5F,
+  /* 00000297 pop es                         */  0x07,
+  /* 00000298 jmp 0x3e2                      */  0xE9, 0x47, 0x01,
+  /* 0000029B push cx                        */  0x51,
+  /* 0000029C push si                        */  0x56,
+  /* 0000029D mov si,0x588                   */  0xBE, 0x88, 0x05,
+  /* 000002A0 call 0x4fa                     */  0xE8, 0x57, 0x02,
+  /* 000002A3 pop si                         */  0x5E,
+  /* 000002A4 and cx,0x1ff                   */  0x81, 0xE1, 0xFF, 0x01,
+  /* 000002A8 sub cx,0xf1                    */  0x81, 0xE9, 0xF1, 0x00,
+  /* 000002AC cmp cx,word [cs:0x104]         */  0x2E, 0x3B, 0x0E, 0x04, 0x01,
+  /* 000002B1 jc 0x2bf                       */  0x72, 0x0C,
+  /* 000002B3 push si                        */  0x56,
+  /* 000002B4 mov si,0x5f4                   */  0xBE, 0xF4, 0x05,
+  /* 000002B7 call 0x4fa                     */  0xE8, 0x40, 0x02,
+  /* 000002BA pop si                         */  0x5E,
+  /* 000002BB pop cx                         */  0x59,
+  /* 000002BC jmp 0x3ee                      */  0xE9, 0x2F, 0x01,
+  /* 000002BF push es                        */  0x06,
+  /* 000002C0 push di                        */  0x57,
+  /* 000002C1 push ds                        */  0x1E,
+  /* 000002C2 push si                        */  0x56,
+  /* 000002C3 push cs                        */  0x0E,
+  /* 000002C4 pop ds                         */  0x1F,
+  /* 000002C5 mov si,cx                      */  0x89, 0xCE,
+  /* 000002C7 shl si,0x8                     */  0xC1, 0xE6, 0x08,
+  /* 000002CA add si,word [ds:0x106]         */  0x03, 0x36, 0x06, 0x01,
+  /* 000002CE mov cx,0x100                   */  0xB9, 0x00, 0x01,
+  /* 000002D1 cld                            */  0xFC,
+  /* 000002D2 rep movsb                      */  0xF3, 0xA4,
+  /* 000002D4 pop si                         */  0x5E,
+  /* 000002D5 pop ds                         */  0x1F,
+  /* 000002D6 pop di                         */  0x5F,
+  /* 000002D7 pop es                         */  0x07,
+  /* 000002D8 pop cx                         */  0x59,
+  /* 000002D9 jmp 0x3e2                      */  0xE9, 0x06, 0x01,
+  /* 000002DC push dx                        */  0x52,
+  /* 000002DD push ax                        */  0x50,
+  /* 000002DE push si                        */  0x56,
+  /* 000002DF mov si,0x59e                   */  0xBE, 0x9E, 0x05,
+  /* 000002E2 call 0x4fa                     */  0xE8, 0x15, 0x02,
+  /* 000002E5 pop si                         */  0x5E,
+  /* 000002E6 test bx,0x4000                 */  0xF7, 0xC3, 0x00, 0x40,
+  /* 000002EA jz 0x2fb                       */  0x74, 0x0F,
+  /* 000002EC mov ax,bx                      */  0x89, 0xD8,
+  /* 000002EE and ax,0x1ff                   */  0x25, 0xFF, 0x01,
+  /* 000002F1 sub ax,0xf1                    */  0x2D, 0xF1, 0x00,
+  /* 000002F4 cmp ax,word [cs:0x104]         */  0x2E, 0x3B, 0x06, 0x04, 0x01,
+  /* 000002F9 jc 0x308                       */  0x72, 0x0D,
+  /* 000002FB push si                        */  0x56,
+  /* 000002FC mov si,0x5f4                   */  0xBE, 0xF4, 0x05,
+  /* 000002FF call 0x4fa                     */  0xE8, 0xF8, 0x01,
+  /* 00000302 pop si                         */  0x5E,
+  /* 00000303 pop ax                         */  0x58,
+  /* 00000304 pop dx                         */  0x5A,
+  /* 00000305 jmp 0x3ee                      */  0xE9, 0xE6, 0x00,
+  /* 00000308 push ds                        */  0x1E,
+  /* 00000309 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 0000030E mov ax,bx                      */  0x89, 0xD8,
+  /* 00000310 and ax,0x41ff                  */  0x25, 0xFF, 0x41,
+  /* 00000313 mov [ds:0x108],ax              */  0xA3, 0x08, 0x01,
+  /* 00000316 pop ds                         */  0x1F,
+  /* 00000317 pop ax                         */  0x58,
+  /* 00000318 pop dx                         */  0x5A,
+  /* 00000319 jmp 0x3e2                      */  0xE9, 0xC6, 0x00,
+  /* 0000031C push si                        */  0x56,
+  /* 0000031D mov si,0x595                   */  0xBE, 0x95, 0x05,
+  /* 00000320 call 0x4fa                     */  0xE8, 0xD7, 0x01,
+  /* 00000323 pop si                         */  0x5E,
+  /* 00000324 push ds                        */  0x1E,
+  /* 00000325 mov ds,word [cs:0x18d]         */  0x2E, 0x8E, 0x1E, 0x8D, 0x01,
+  /* 0000032A mov bx,word [ds:0x108]         */  0x8B, 0x1E, 0x08, 0x01,
+  /* 0000032E pop ds                         */  0x1F,
+  /* 0000032F jmp 0x3e2                      */  0xE9, 0xB0, 0x00,
+  /* 00000332 push si                        */  0x56,
+  /* 00000333 mov si,0x602                   */  0xBE, 0x02, 0x06,
+  /* 00000336 call 0x4fa                     */  0xE8, 0xC1, 0x01,
+  /* 00000339 pop si                         */  0x5E,
+  /* 0000033A jmp 0x3ee                      */  0xE9, 0xB1, 0x00,
+  /* 0000033D push si                        */  0x56,
+  /* 0000033E mov si,0x615                   */  0xBE, 0x15, 0x06,
+  /* 00000341 call 0x4fa                     */  0xE8, 0xB6, 0x01,
+  /* 00000344 pop si                         */  0x5E,
+  /* 00000345 cmp word [cs:0x18b],0x0        */  0x2E, 0x83, 0x3E, 0x8B, 0x01, 0x00,
+  /* 0000034B jz 0x357                       */  0x74, 0x0A,
+  /* 0000034D cmp bl,0x0                     */  0x80, 0xFB, 0x00,
+  /* 00000350 jz 0x35a                       */  0x74, 0x08,
+  /* 00000352 cmp bl,0x1                     */  0x80, 0xFB, 0x01,
+  /* 00000355 jz 0x360                       */  0x74, 0x09,
+  /* 00000357 jmp 0x3ee                      */  0xE9, 0x94, 0x00,
+  /* 0000035A mov bx,0x2                     */  0xBB, 0x02, 0x00,
+  /* 0000035D jmp 0x3e2                      */  0xE9, 0x82, 0x00,
+  /* 00000360 cmp dx,word [cs:0x18b]         */  0x2E, 0x3B, 0x16, 0x8B, 0x01,
+  /* 00000365 jnc 0x357                      */  0x73, 0xF0,
+  /* 00000367 push di                        */  0x57,
+  /* 00000368 push ds                        */  0x1E,
+  /* 00000369 push si                        */  0x56,
+  /* 0000036A push cx                        */  0x51,
+  /* 0000036B push cs                        */  0x0E,
+  /* 0000036C pop ds                         */  0x1F,
+  /* 0000036D mov si,dx                      */  0x89, 0xD6,
+  /* 0000036F shl si,0x7                     */  0xC1, 0xE6, 0x07,
+  /* 00000372 add si,word [ds:0x189]         */  0x03, 0x36, 0x89, 0x01,
+  /* 00000376 mov cx,0x80                    */  0xB9, 0x80, 0x00,
+  /* 00000379 cld                            */  0xFC,
+  /* 0000037A rep movsb                      */  0xF3, 0xA4,
+  /* 0000037C pop cx                         */  0x59,
+  /* 0000037D pop si                         */  0x5E,
+  /* 0000037E pop ds                         */  0x1F,
+  /* 0000037F pop di                         */  0x5F,
+  /* 00000380 jmp short 0x3e2                */  0xEB, 0x60,
+  /* 00000382 push si                        */  0x56,
+  /* 00000383 mov si,0x5a7                   */  0xBE, 0xA7, 0x05,
+  /* 00000386 call 0x4fa                     */  0xE8, 0x71, 0x01,
+  /* 00000389 pop si                         */  0x5E,
+  /* 0000038A cmp al,0x7                     */  0x3C, 0x07,
+  /* 0000038C ja 0x39a                       */  0x77, 0x0C,
+  /* 0000038E cmp al,0x6                     */  0x3C, 0x06,
+  /* 00000390 jz 0x396                       */  0x74, 0x04,
+  /* 00000392 mov al,0x30                    */  0xB0, 0x30,
+  /* 00000394 jmp short 0x39c                */  0xEB, 0x06,
+  /* 00000396 mov al,0x3f                    */  0xB0, 0x3F,
+  /* 00000398 jmp short 0x39c                */  0xEB, 0x02,
+  /* 0000039A mov al,0x20                    */  0xB0, 0x20,
+  /* 0000039C push si                        */  0x56,
+  /* 0000039D mov si,0x55a                   */  0xBE, 0x5A, 0x05,
+  /* 000003A0 call 0x4fa                     */  0xE8, 0x57, 0x01,
+  /* 000003A3 pop si                         */  0x5E,
+  /* 000003A4 iretw                          */  0xCF,
+  /* 000003A5 push si                        */  0x56,
+  /* 000003A6 mov si,0x5b6                   */  0xBE, 0xB6, 0x05,
+  /* 000003A9 call 0x4fa                     */  0xE8, 0x4E, 0x01,
+  /* 000003AC pop si                         */  0x5E,
+  /* 000003AD mov ax,0x5003                  */  0xB8, 0x03, 0x50,
+  /* 000003B0 xor bh,bh                      */  0x30, 0xFF,
+  /* 000003B2 iretw                          */  0xCF,
+  /* 000003B3 cmp bl,0x10                    */  0x80, 0xFB, 0x10,
+  /* 000003B6 jnz 0x3d9                      */  0x75, 0x21,
+  /* 000003B8 push si                        */  0x56,
+  /* 000003B9 mov si,0x5c5                   */  0xBE, 0xC5, 0x05,
+  /* 000003BC call 0x4fa                     */  0xE8, 0x3B, 0x01,
+  /* 000003BF pop si                         */  0x5E,
+  /* 000003C0 mov bx,0x3                     */  0xBB, 0x03, 0x00,
+  /* 000003C3 mov cx,0x9                     */  0xB9, 0x09, 0x00,
+  /* 000003C6 iretw                          */  0xCF,
+  /* 000003C7 cmp al,0x0                     */  0x3C, 0x00,
+  /* 000003C9 jnz 0x3d9                      */  0x75, 0x0E,
+  /* 000003CB push si                        */  0x56,
+  /* 000003CC mov si,0x5d7                   */  0xBE, 0xD7, 0x05,
+  /* 000003CF call 0x4fa                     */  0xE8, 0x28, 0x01,
+  /* 000003D2 pop si                         */  0x5E,
+  /* 000003D3 mov al,0x1a                    */  0xB0, 0x1A,
+  /* 000003D5 mov bx,0x8                     */  0xBB, 0x08, 0x00,
+  /* 000003D8 iretw                          */  0xCF,
+  /* 000003D9 push si                        */  0x56,
+  /* 000003DA mov si,0x56d                   */  0xBE, 0x6D, 0x05,
+  /* 000003DD call 0x4fa                     */  0xE8, 0x1A, 0x01,
+  /* 000003E0 pop si                         */  0x5E,
+  /* 000003E1 iretw                          */  0xCF,
+  /* 000003E2 push si                        */  0x56,
+  /* 000003E3 mov si,0x55a                   */  0xBE, 0x5A, 0x05,
+  /* 000003E6 call 0x4fa                     */  0xE8, 0x11, 0x01,
+  /* 000003E9 pop si                         */  0x5E,
+  /* 000003EA mov ax,0x4f                    */  0xB8, 0x4F, 0x00,
+  /* 000003ED iretw                          */  0xCF,
+  /* 000003EE push si                        */  0x56,
+  /* 000003EF mov si,0x560                   */  0xBE, 0x60, 0x05,
+  /* 000003F2 call 0x4fa                     */  0xE8, 0x05, 0x01,
+  /* 000003F5 pop si                         */  0x5E,
+  /* 000003F6 mov ax,0x14f                   */  0xB8, 0x4F, 0x01,
+  /* 000003F9 iretw                          */  0xCF,
+  /* 000003FA push si                        */  0x56,
+  /* 000003FB mov si,0x56d                   */  0xBE, 0x6D, 0x05,
+  /* 000003FE call 0x4fa                     */  0xE8, 0xF9, 0x00,
+  /* 00000401 pop si                         */  0x5E,
+  /* 00000402 mov ax,0x24f                   */  0xB8, 0x4F, 0x02,
+  /* 00000405 iretw                          */  0xCF,
+  /* 00000406 jnp 0x40a                      */  0x7B, 0x02,
+  /* 00000408 fwait                          */  0x9B,
+  /* 00000409 add bl,ah                      */  0x02, 0xDC,
+  /* 0000040B add bl,byte [si]               */  0x02, 0x1C,
+  /* 0000040D add di,dx                      */  0x03, 0xFA,
+  /* 0000040F add di,dx                      */  0x03, 0xFA,
+  /* 00000411 add di,dx                      */  0x03, 0xFA,
+  /* 00000413 add di,dx                      */  0x03, 0xFA,
+  /* 00000415 add di,dx                      */  0x03, 0xFA,
+  /* 00000417 add di,dx                      */  0x03, 0xFA,
+  /* 00000419 add di,dx                      */  0x03, 0xFA,
+  /* 0000041B add di,dx                      */  0x03, 0xFA,
+  /* 0000041D add di,dx                      */  0x03, 0xFA,
+  /* 0000041F add di,dx                      */  0x03, 0xFA,
+  /* 00000421 add di,dx                      */  0x03, 0xFA,
+  /* 00000423 add di,dx                      */  0x03, 0xFA,
+  /* 00000425 add si,word [bp+si]            */  0x03, 0x32,
+  /* 00000427 add di,dx                      */  0x03, 0xFA,
+  /* 00000429 add di,dx                      */  0x03, 0xFA,
+  /* 0000042B add di,dx                      */  0x03, 0xFA,
+  /* 0000042D add di,dx                      */  0x03, 0xFA,
+  /* 0000042F add di,word [di]               */  0x03, 0x3D,
+  /* 00000431 add ax,word [bp+si-0x26fd]     */  0x03, 0x82, 0x03, 0xD9,
+  /* 00000435 add bx,cx                      */  0x03, 0xD9,
+  /* 00000437 add bx,cx                      */  0x03, 0xD9,
+  /* 00000439 add bx,cx                      */  0x03, 0xD9,
+  /* 0000043B add bx,cx                      */  0x03, 0xD9,
+  /* 0000043D add bx,cx                      */  0x03, 0xD9,
+  /* 0000043F add bx,cx                      */  0x03, 0xD9,
+  /* 00000441 add bx,cx                      */  0x03, 0xD9,
+  /* 00000443 add bx,cx                      */  0x03, 0xD9,
+  /* 00000445 add bx,cx                      */  0x03, 0xD9,
+  /* 00000447 add bx,cx                      */  0x03, 0xD9,
+  /* 00000449 add bx,cx                      */  0x03, 0xD9,
+  /* 0000044B add bx,cx                      */  0x03, 0xD9,
+  /* 0000044D add bx,cx                      */  0x03, 0xD9,
+  /* 0000044F add sp,word [di-0x26fd]        */  0x03, 0xA5, 0x03, 0xD9,
+  /* 00000453 add bx,cx                      */  0x03, 0xD9,
+  /* 00000455 add si,word [bp+di-0x26fd]     */  0x03, 0xB3, 0x03, 0xD9,
+  /* 00000459 add bx,cx                      */  0x03, 0xD9,
+  /* 0000045B add bx,cx                      */  0x03, 0xD9,
+  /* 0000045D add bx,cx                      */  0x03, 0xD9,
+  /* 0000045F add bx,cx                      */  0x03, 0xD9,
+  /* 00000461 add bx,cx                      */  0x03, 0xD9,
+  /* 00000463 add bx,cx                      */  0x03, 0xD9,
+  /* 00000465 add ax,di                      */  0x03, 0xC7,
+  /* 00000467 add bx,cx                      */  0x03, 0xD9,
+  /* 00000469 add bx,cx                      */  0x03, 0xD9,
+  /* 0000046B add bx,cx                      */  0x03, 0xD9,
+  /* 0000046D add bx,cx                      */  0x03, 0xD9,
+  /* 0000046F add bx,cx                      */  0x03, 0xD9,
+  /* 00000471 add dx,word [bx+0x2e]          */  0x03, 0x57, 0x2E,
+  /* 00000474 cmp word [ds:0x17a],0x0        */  0x83, 0x3E, 0x7A, 0x01, 0x00,
+  /* 00000479 jz 0x4d8                       */  0x74, 0x5D,
+  /* 0000047B mov di,word [cs:0x17c]         */  0x2E, 0x8B, 0x3E, 0x7C, 0x01,
+  /* 00000480 shl di,0x4                     */  0xC1, 0xE7, 0x04,
+  /* 00000483 add di,word [cs:0x178]         */  0x2E, 0x03, 0x3E, 0x78, 0x01,
+  /* 00000488 mov word [cs:0x17e],di         */  0x2E, 0x89, 0x3E, 0x7E, 0x01,
+  /* 0000048D mov word [cs:di],ax            */  0x2E, 0x89, 0x05,
+  /* 00000490 mov word [cs:di+0x2],bx        */  0x2E, 0x89, 0x5D, 0x02,
+  /* 00000494 mov word [cs:di+0x4],cx        */  0x2E, 0x89, 0x4D, 0x04,
+  /* 00000498 mov word [cs:di+0x6],dx        */  0x2E, 0x89, 0x55, 0x06,
+  /* 0000049C mov word [cs:di+0x8],0x0       */  0x2E, 0xC7, 0x45, 0x08, 0x00, 0x00,
+  /* 000004A2 mov word [cs:di+0xa],0x0       */  0x2E, 0xC7, 0x45, 0x0A, 0x00, 0x00,
+  /* 000004A8 mov word [cs:di+0xc],0x0       */  0x2E, 0xC7, 0x45, 0x0C, 0x00, 0x00,
+  /* 000004AE mov word [cs:di+0xe],0x0       */  0x2E, 0xC7, 0x45, 0x0E, 0x00, 0x00,
+  /* 000004B4 inc word [cs:0x17c]            */  0x2E, 0xFF, 0x06, 0x7C, 0x01,
+  /* 000004B9 mov di,word [cs:0x17c]         */  0x2E, 0x8B, 0x3E, 0x7C, 0x01,
+  /* 000004BE cmp di,word [cs:0x17a]         */  0x2E, 0x3B, 0x3E, 0x7A, 0x01,
+  /* 000004C3 jc 0x4cc                       */  0x72, 0x07,
+  /* 000004C5 mov word [cs:0x17c],0x0        */  0x2E, 0xC7, 0x06, 0x7C, 0x01, 0x00, 0x00,
+  /* 000004CC add word [cs:0x180],0x1        */  0x2E, 0x83, 0x06, 0x80, 0x01, 0x01,
+  /* 000004D2 adc word [cs:0x182],0x0        */  0x2E, 0x83, 0x16, 0x82, 0x01, 0x00,
+  /* 000004D8 pop di                         */  0x5F,
+  /* 000004D9 ret                            */  0xC3,
+  /* 000004DA push di                        */  0x57,
+  /* 000004DB cmp word [cs:0x17a],0x0        */  0x2E, 0x83, 0x3E, 0x7A, 0x01, 0x00,
+  /* 000004E1 jz 0x4f8                       */  0x74, 0x15,
+  /* 000004E3 mov di,word [cs:0x17e]         */  0x2E, 0x8B, 0x3E, 0x7E, 0x01,
+  /* 000004E8 mov word [cs:di+0x8],ax        */  0x2E, 0x89, 0x45, 0x08,
+  /* 000004EC mov word [cs:di+0xa],bx        */  0x2E, 0x89, 0x5D, 0x0A,
+  /* 000004F0 mov word [cs:di+0xc],cx        */  0x2E, 0x89, 0x4D, 0x0C,
+  /* 000004F4 mov word [cs:di+0xe],dx        */  0x2E, 0x89, 0x55, 0x0E,
+  /* 000004F8 pop di                         */  0x5F,
+  /* 000004F9 iretw                          */  0xCF,
+  /* 000004FA pushaw                         */  0x60,
+  /* 000004FB push ds                        */  0x1E,
+  /* 000004FC push cs                        */  0x0E,
+  /* 000004FD pop ds                         */  0x1F,
+  /* 000004FE cmp word [ds:0x184],0x0        */  0x83, 0x3E, 0x84, 0x01, 0x00,
+  /* 00000503 jz 0x525                       */  0x74, 0x20,
+  /* 00000505 cmp byte [ds:0x188],0x0        */  0x80, 0x3E, 0x88, 0x01, 0x00,
+  /* 0000050A jnz 0x50f                      */  0x75, 0x03,
+  /* 0000050C call 0x528                     */  0xE8, 0x19, 0x00,
+  /* 0000050F mov bx,word [ds:0x184]         */  0x8B, 0x1E, 0x84, 0x01,
+  /* 00000513 lea dx,[bx+0x5]                */  0x8D, 0x57, 0x05,
+  /* 00000516 in al,dx                       */  0xEC,
+  /* 00000517 test al,0x20                   */  0xA8, 0x20,
+  /* 00000519 jz 0x513                       */  0x74, 0xF8,
+  /* 0000051B lodsb                          */  0xAC,
+  /* 0000051C cmp al,0x0                     */  0x3C, 0x00,
+  /* 0000051E jz 0x525                       */  0x74, 0x05,
+  /* 00000520 mov dx,bx                      */  0x89, 0xDA,
+  /* 00000522 out dx,al                      */  0xEE,
+  /* 00000523 jmp short 0x513                */  0xEB, 0xEE,
+  /* 00000525 pop ds                         */  0x1F,
+  /* 00000526 popaw                          */  0x61,
+  /* 00000527 ret                            */  0xC3,
+  /* 00000528 mov bx,word [ds:0x184]         */  0x8B, 0x1E, 0x84, 0x01,
+  /* 0000052C lea dx,[bx+0x1]                */  0x8D, 0x57, 0x01,
+  /* 0000052F mov al,0x0                     */  0xB0, 0x00,
+  /* 00000531 out dx,al                      */  0xEE,
+  /* 00000532 lea dx,[bx+0x3]                */  0x8D, 0x57, 0x03,
+  /* 00000535 mov al,0x80                    */  0xB0, 0x80,
+  /* 00000537 out dx,al                      */  0xEE,
+  /* 00000538 mov ax,[ds:0x186]              */  0xA1, 0x86, 0x01,
+  /* 0000053B mov dx,bx                      */  0x89, 0xDA,
+  /* 0000053D out dx,al                      */  0xEE,
+  /* 0000053E inc dx                         */  0x42,
+  /* 0000053F mov al,ah                      */  0x88, 0xE0,
+  /* 00000541 out dx,al                      */  0xEE,
+  /* 00000542 lea dx,[bx+0x3]                */  0x8D, 0x57, 0x03,
+  /* 00000545 mov al,0x3                     */  0xB0, 0x03,
+  /* 00000547 out dx,al                      */  0xEE,
+  /* 00000548 lea dx,[bx+0x2]                */  0x8D, 0x57, 0x02,
+  /* 0000054B mov al,0xc7                    */  0xB0, 0xC7,
+  /* 0000054D out dx,al                      */  0xEE,
+  /* 0000054E lea dx,[bx+0x4]                */  0x8D, 0x57, 0x04,
+  /* 00000551 mov al,0xb                     */  0xB0, 0x0B,
+  /* 00000553 out dx,al                      */  0xEE,
+  /* 00000554 mov byte [ds:0x188],0x1        */  0xC6, 0x06, 0x88, 0x01, 0x01,
+  /* 00000559 ret                            */  0xC3,
+  /* 0000055A inc bp                         */  0x45,
+  /* 0000055B js 0x5c6                       */  0x78, 0x69,
+  /* 0000055D jz 0x569                       */  0x74, 0x0A,
+  /* 0000055F add byte [di+0x6e],dl          */  0x00, 0x55, 0x6E,
+  /* 00000562 jnc 0x5d9                      */  0x73, 0x75,
+  /* 00000564 jo 0x5d6                       */  0x70, 0x70,
+  /* 00000566 outs dx,word [ds:si]           */  0x6F,
+  /* 00000567 jc 0x5dd                       */  0x72, 0x74,
+  /* 00000569 gs or al,byte fs:[bx+si]       */  0x65, 0x64, 0x0A, 0x00,
+  /* 0000056D push bp                        */  0x55,
+  /* 0000056E outs dx,byte [ds:si]           */  0x6E,
+  /* 0000056F imul bp,word [bp+0x6f],0x77    */  0x6B, 0x6E, 0x6F, 0x77,
+  /* 00000573 outs dx,byte [ds:si]           */  0x6E,
+  /* 00000574 and byte [bp+0x75],al          */  0x20, 0x46, 0x75,
+  /* 00000577 outs dx,byte [ds:si]           */  0x6E,
+  /* 00000578 arpl word [si+0x69],si         */  0x63, 0x74, 0x69,
+  /* 0000057B outs dx,word [ds:si]           */  0x6F,
+  /* 0000057C outs dx,byte [ds:si]           */  0x6E,
+  /* 0000057D or al,byte [bx+si]             */  0x0A, 0x00,
+  /* 0000057F inc di                         */  0x47,
+  /* 00000580 gs je 0x5cc                    */  0x65, 0x74, 0x49,
+  /* 00000583 outs dx,byte [ds:si]           */  0x6E,
+  /* 00000584 outs dx,Dword [ds:si]          */  0x66, 0x6F,
+  /* 00000586 or al,byte [bx+si]             */  0x0A, 0x00,
+  /* 00000588 inc di                         */  0x47,
+  /* 00000589 gs je 0x5d9                    */  0x65, 0x74, 0x4D,
+  /* 0000058C outs dx,word [ds:si]           */  0x6F,
+  /* 0000058D fs gs dec cx                   */  0x64, 0x65, 0x49,
+  /* 00000590 outs dx,byte [ds:si]           */  0x6E,
+  /* 00000591 outs dx,Dword [ds:si]          */  0x66, 0x6F,
+  /* 00000593 or al,byte [bx+si]             */  0x0A, 0x00,
+  /* 00000595 inc di                         */  0x47,
+  /* 00000596 gs je 0x5e6                    */  0x65, 0x74, 0x4D,
+  /* 00000599 outs dx,word [ds:si]           */  0x6F,
+  /* 0000059A fs or al,byte gs:[bx+si]       */  0x64, 0x65, 0x0A, 0x00,
+  /* 0000059E push bx                        */  0x53,
+  /* 0000059F gs je 0x5ef                    */  0x65, 0x74, 0x4D,
+  /* 000005A2 outs dx,word [ds:si]           */  0x6F,
+  /* 000005A3 fs or al,byte gs:[bx+si]       */  0x64, 0x65, 0x0A, 0x00,
+  /* 000005A7 push bx                        */  0x53,
+  /* 000005A8 gs je 0x5f8                    */  0x65, 0x74, 0x4D,
+  /* 000005AB outs dx,word [ds:si]           */  0x6F,
+  /* 000005AC fs gs dec sp                   */  0x64, 0x65, 0x4C,
+  /* 000005AF gs addr32 popa                 */  0x65, 0x67, 0x61,
+  /* 000005B2 arpl word [bx+di+0xa],di       */  0x63, 0x79, 0x0A,
+  /* 000005B5 add byte [bx+0x65],al          */  0x00, 0x47, 0x65,
+  /* 000005B8 jz 0x607                       */  0x74, 0x4D,
+  /* 000005BA outs dx,word [ds:si]           */  0x6F,
+  /* 000005BB fs gs dec sp                   */  0x64, 0x65, 0x4C,
+  /* 000005BE gs addr32 popa                 */  0x65, 0x67, 0x61,
+  /* 000005C1 arpl word [bx+di+0xa],di       */  0x63, 0x79, 0x0A,
+  /* 000005C4 add byte [bx+0x65],al          */  0x00, 0x47, 0x65,
+  /* 000005C7 jz 0x60e                       */  0x74, 0x45,
+  /* 000005C9 addr32 popa                    */  0x67, 0x61,
+  /* 000005CB dec cx                         */  0x49,
+  /* 000005CC outs dx,byte [ds:si]           */  0x6E,
+  /* 000005CD outs dx,Dword [ds:si]          */  0x66, 0x6F,
+  /* 000005CF dec sp                         */  0x4C,
+  /* 000005D0 gs addr32 popa                 */  0x65, 0x67, 0x61,
+  /* 000005D3 arpl word [bx+di+0xa],di       */  0x63, 0x79, 0x0A,
+  /* 000005D6 add byte [bx+0x65],al          */  0x00, 0x47, 0x65,
+  /* 000005D9 jz 0x61f                       */  0x74, 0x44,
+  /* 000005DB imul si,word [bp+di+0x70],0x61 */  0x69, 0x73, 0x70, 0x6C, 0x61,
+  /* 000005E0 jns 0x625                      */  0x79, 0x43,
+  /* 000005E2 outs dx,word [ds:si]           */  0x6F,
+  /* 000005E3 ins word [es:di],dx            */  0x6D,
+  /* 000005E4 bound bp,Dword [bx+di+0x6e]    */  0x62, 0x69, 0x6E,
+  /* 000005E7 popaw                          */  0x61,
+  /* 000005E8 jz 0x653                       */  0x74, 0x69,
+  /* 000005EA outs dx,word [ds:si]           */  0x6F,
+  /* 000005EB outs dx,byte [ds:si]           */  0x6E,
+  /* 000005EC dec sp                         */  0x4C,
+  /* 000005ED gs addr32 popa                 */  0x65, 0x67, 0x61,
+  /* 000005F0 arpl word [bx+di+0xa],di       */  0x63, 0x79, 0x0A,
+  /* 000005F3 add byte [di+0x6e],dl          */  0x00, 0x55, 0x6E,
+  /* 000005F6 imul bp,word [bp+0x6f],0x77    */  0x6B, 0x6E, 0x6F, 0x77,
+  /* 000005FA outs dx,byte [ds:si]           */  0x6E,
+  /* 000005FB and byte [di+0x6f],cl          */  0x20, 0x4D, 0x6F,
+  /* 000005FE fs or al,byte gs:[bx+si]       */  0x64, 0x65, 0x0A, 0x00,
+  /* 00000602 inc di                         */  0x47,
+  /* 00000603 gs je 0x656                    */  0x65, 0x74, 0x50,
+  /* 00000606 ins word [es:di],dx            */  0x6D,
+  /* 00000607 inc bx                         */  0x43,
+  /* 00000608 popaw                          */  0x61,
+  /* 00000609 jo 0x66c                       */  0x70, 0x61,
+  /* 0000060B bound bp,Dword [bx+di+0x6c]    */  0x62, 0x69, 0x6C,
+  /* 0000060E imul si,word [si+0x69],0x7365  */  0x69, 0x74, 0x69, 0x65, 0x73,
+  /* 00000613 or al,byte [bx+si]             */  0x0A, 0x00,
+  /* 00000615 push dx                        */  0x52,
+  /* 00000616 gs popa                        */  0x65, 0x61,
+  /* 00000618 fs inc bp                      */  0x64, 0x45,
+  /* 0000061A imul sp,word fs:[si+0xa],0x490 */  0x64, 0x69, 0x64, 0x0A, 0x00, 0x49,
+  /* 00000620 outs dx,byte [ds:si]           */  0x6E,
+  /* 00000621 jz 0x688                       */  0x74, 0x65,
+  /* 00000623 jc 0x697                       */  0x72, 0x72,
+  /* 00000625 jnz 0x697                      */  0x75, 0x70,
+  /* 00000627 jz 0x671                       */  0x74, 0x48,
+  /* 00000629 popaw                          */  0x61,
+  /* 0000062A outs dx,byte [ds:si]           */  0x6E,
+  /* 0000062B fs ins byte [es:di],dx         */  0x64, 0x6C,
+  /* 0000062D gs jb 0x675                    */  0x65, 0x72, 0x45,
+  /* 00000630 outs dx,byte [ds:si]           */  0x6E,
+  /* 00000631 jz 0x6a5                       */  0x74, 0x72,
+  /* 00000633 jns 0x63f                      */  0x79, 0x0A,
 };
 #endif
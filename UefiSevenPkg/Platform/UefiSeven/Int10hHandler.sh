@@ -32,43 +32,57 @@ exit_handler()
 trap exit_handler EXIT
 
 #
-# Assemble the source file.
+# Assemble the source file with the given extra NASM options and dump it as a
+# C array with the given name.
 #
-nasm -o "$STEM".bin "$STEM".asm
+dump_handler()
+{
+  NAME=$1
+  shift
 
-#
-# Disassemble it, in order to get a binary dump associated with the source.
-# (ndisasm doesn't recognize the "--" end-of-options delimiter.)
-#
-ndisasm "$STEM".bin >"$STEM".disasm
+  #
+  # Assemble the source file.
+  #
+  nasm "$@" -o "$STEM".bin "$STEM".asm
 
-#
-# Create three files, each with one column of the disassembly.
-#
-# The first column contains the offsets, and it starts the comment.
-#
-cut -c 1-8 -- "$STEM".disasm \
-| sed -e 's,^,  /* ,' >"$STEM".offsets
+  #
+  # Disassemble it, in order to get a binary dump associated with the source.
+  # (ndisasm doesn't recognize the "--" end-of-options delimiter.)
+  #
+  ndisasm "$STEM".bin >"$STEM".disasm
 
-#
-# The second column contains the assembly-language instructions, and it closes
-# the comment. We first pad it to 30 characters.
-#
-cut -c 29- -- "$STEM".disasm \
-| sed -e 's,$,                              ,' \
-      -e 's,^\(.\{30\}\).*$,\1 */,' >"$STEM".insns
+  #
+  # Create three files, each with one column of the disassembly.
+  #
+  # The first column contains the offsets, and it starts the comment.
+  #
+  cut -c 1-8 -- "$STEM".disasm \
+  | sed -e 's,^,  /* ,' >"$STEM".offsets
 
-#
-# The third column contains the bytes corresponding to the instruction,
-# represented as C integer constants. First strip trailing whitespace from the
-# middle column of the input disassembly, then process pairs of nibbles.
-#
-cut -c 11-28 -- "$STEM".disasm \
-| sed -e 's, \+$,,' -e 's/\(..\)/ 0x\1,/g' >"$STEM".bytes
+  #
+  # The second column contains the assembly-language instructions, and it
+  # closes the comment. We first pad it to 30 characters.
+  #
+  cut -c 29- -- "$STEM".disasm \
+  | sed -e 's,$,                              ,' \
+        -e 's,^\(.\{30\}\).*$,\1 */,' >"$STEM".insns
+
+  #
+  # The third column contains the bytes corresponding to the instruction,
+  # represented as C integer constants. First strip trailing whitespace from
+  # the middle column of the input disassembly, then process pairs of nibbles.
+  #
+  cut -c 11-28 -- "$STEM".disasm \
+  | sed -e 's, \+$,,' -e 's/\(..\)/ 0x\1,/g' >"$STEM".bytes
+
+  printf 'STATIC CONST UINT8 %s[] = {\n' "$NAME"
+  paste -d ' ' -- "$STEM".offsets "$STEM".insns "$STEM".bytes
+  printf '};\n'
+}
 
 #
-# Write the output file, recombining the columns. The output should have CRLF
-# line endings.
+# Write the output file with the release handler and the instrumented one,
+# recombining the columns. The output should have CRLF line endings.
 #
 {
   printf '//\n'
@@ -78,9 +92,8 @@ cut -c 11-28 -- "$STEM".disasm \
   printf '#include <Uefi.h>\n'
   printf '#ifndef __INT10H_HANDLER_H\n'
   printf '#define __INT10H_HANDLER_H\n'
-  printf 'STATIC CONST UINT8 INT10H_HANDLER[] = {\n'
-  paste -d ' ' -- "$STEM".offsets "$STEM".insns "$STEM".bytes
-  printf '};\n'
+  dump_handler INT10H_HANDLER
+  dump_handler INT10H_HANDLER_TRACE -DTRACE -DDEBUG
   printf '#endif\n'
 } \
 | todos >"$STEM".h
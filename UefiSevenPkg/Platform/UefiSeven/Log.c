@@ -0,0 +1,812 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "Log.h"
+#include "Filesystem.h"
+#include "Timing.h"
+
+
+/**
+  -----------------------------------------------------------------------------
+  Variables.
+  -----------------------------------------------------------------------------
+**/
+
+STATIC LOG_RING           mLogRing;
+STATIC LOG_RING           mTableRing;         // only if the table and file formats differ
+STATIC BOOLEAN            mTableBinary      = FALSE;
+STATIC LOG_FILE_HEADER    mLogFileHeader;
+STATIC LOG_TABLE          *mLogTable        = NULL;
+STATIC UINT8              mRecordBuffer[BLOG_RECORD_MAX];
+
+
+/**
+  -----------------------------------------------------------------------------
+  Local method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Writes data at a particular position in the log file.
+
+  @param[in] Position     Byte offset within the file.
+  @param[in] Data         Data to be written.
+  @param[in] Length       Number of bytes to be written.
+
+  @retval EFI_SUCCESS     All bytes were written.
+  @retval other           The write failed.
+
+**/
+EFI_STATUS
+LogFileWriteAt (
+  IN  UINT64        Position,
+  IN  CONST VOID    *Data,
+  IN  UINTN         Length
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       BufferSize;
+
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Status = mLogFileHandle->SetPosition (mLogFileHandle, Position);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  BufferSize = Length;
+  Status = mLogFileHandle->Write (mLogFileHandle, &BufferSize, (VOID *)Data);
+  if (!EFI_ERROR (Status) && (BufferSize != Length)) {
+    Status = EFI_VOLUME_FULL;
+  }
+
+  return Status;
+}
+
+
+/**
+  Writes a contiguous part of the ring buffer to the data area
+  of the log file, wrapping around at its end.
+
+  @param[in] Offset       Offset within the ring buffer.
+  @param[in] Length       Number of bytes to be written.
+
+  @retval EFI_SUCCESS     All bytes were written.
+  @retval other           The write failed.
+
+**/
+EFI_STATUS
+LogWriteChunk (
+  IN  UINTN   Offset,
+  IN  UINTN   Length
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Part;
+
+  while (Length > 0) {
+    Part = MIN (Length, mLogFileHeader.DataSize - mLogFileHeader.WriteOffset);
+    Status = LogFileWriteAt (
+               mLogFileHeader.DataOffset + mLogFileHeader.WriteOffset,
+               mLogRing.Buffer + Offset,
+               Part);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Offset += Part;
+    Length -= Part;
+    mLogFileHeader.WriteOffset += (UINT32)Part;
+    if (mLogFileHeader.WriteOffset == mLogFileHeader.DataSize) {
+      mLogFileHeader.WriteOffset  = 0;
+      mLogFileHeader.Wrapped      = TRUE;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Refreshes the published log table with the current state of
+  the log ring and the boot phase timers.
+
+**/
+VOID
+LogTableUpdate (
+  VOID
+  )
+{
+  CONST PHASE_TIMER   *PhaseTimers;
+  UINT64              EntryTicks;
+  UINT64              CalibrationTicks;
+  UINTN               Index;
+
+  if (mLogTable == NULL) {
+    return;
+  }
+
+  GetBootTimings (&EntryTicks, &CalibrationTicks, &PhaseTimers);
+  for (Index = 0; Index < mLogTable->PhaseCount; Index++) {
+    mLogTable->Phases[Index].Ticks = PhaseTimers[Index].Ticks;
+    mLogTable->Phases[Index].Count = PhaseTimers[Index].Count;
+  }
+
+  mLogTable->EntryTsc         = EntryTicks;
+  mLogTable->CalibrationTicks = CalibrationTicks;
+  mLogTable->LogHead          = (mTableRing.Buffer != NULL) ? mTableRing.Head : mLogRing.Head;
+  mLogTable->UpdateTsc        = AsmReadTsc ();
+}
+
+
+/**
+  Converts a pointer into UefiSeven's own image into an offset
+  that the host decoder can look up in the built .efi file.
+
+  @param[in] Pointer      Pointer to a string within the image.
+
+  @retval UINT32          Offset from the image base.
+
+**/
+UINT32
+BlogImageOffset (
+  IN  CONST VOID  *Pointer
+  )
+{
+  return (UINT32)((UINTN)Pointer - (UINTN)mUefiSevenImageInfo->ImageBase);
+}
+
+
+/**
+  Appends bytes to the binary record being built.
+
+  @param[in,out] Cursor   Current write position, advanced on success.
+  @param[in] Data         Bytes to be appended.
+  @param[in] Length       Number of bytes to be appended.
+
+  @retval TRUE            The bytes were appended.
+  @retval FALSE           The record is full.
+
+**/
+BOOLEAN
+BlogPut (
+  IN OUT  UINT8         **Cursor,
+  IN      CONST VOID    *Data,
+  IN      UINTN         Length
+  )
+{
+  if ((UINTN)(mRecordBuffer + sizeof (mRecordBuffer) - *Cursor) < Length) {
+    return FALSE;
+  }
+
+  CopyMem (*Cursor, Data, Length);
+  *Cursor += Length;
+  return TRUE;
+}
+
+
+/**
+  Appends a length-prefixed ASCII string to the binary record,
+  narrowing it first if it is a CHAR16 string.
+
+  @param[in,out] Cursor   Current write position, advanced on success.
+  @param[in] String       The string, may be NULL.
+  @param[in] IsUnicode    Whether String points to CHAR16 characters.
+
+  @retval TRUE            The string was appended.
+  @retval FALSE           The record is full.
+
+**/
+BOOLEAN
+BlogPutString (
+  IN OUT  UINT8         **Cursor,
+  IN      CONST VOID    *String,
+  IN      BOOLEAN       IsUnicode
+  )
+{
+  CONST CHAR16  *UnicodeString;
+  CONST CHAR8   *AsciiString;
+  UINT16        Length;
+  UINT16        Index;
+
+  if (String == NULL) {
+    String    = "<null string>";
+    IsUnicode = FALSE;
+  }
+
+  UnicodeString = String;
+  AsciiString   = String;
+  Length = (UINT16)(IsUnicode ? StrLen (UnicodeString) : AsciiStrLen (AsciiString));
+  if ((UINTN)(mRecordBuffer + sizeof (mRecordBuffer) - *Cursor) < sizeof (Length) + Length) {
+    return FALSE;
+  }
+
+  BlogPut (Cursor, &Length, sizeof (Length));
+  for (Index = 0; Index < Length; Index++) {
+    (*Cursor)[Index] = IsUnicode ? (UINT8)UnicodeString[Index] : (UINT8)AsciiString[Index];
+  }
+  *Cursor += Length;
+  return TRUE;
+}
+
+
+/**
+  Appends a present flag and a 16 byte structure (GUID or time)
+  to the binary record.
+
+  @param[in,out] Cursor   Current write position, advanced on success.
+  @param[in] Data         The structure, may be NULL.
+
+  @retval TRUE            The structure was appended.
+  @retval FALSE           The record is full.
+
+**/
+BOOLEAN
+BlogPutBlob16 (
+  IN OUT  UINT8         **Cursor,
+  IN      CONST VOID    *Data
+  )
+{
+  STATIC CONST UINT8  Zero[16] = { 0 };
+  UINT8               Present;
+
+  Present = (Data != NULL) ? 1 : 0;
+  if ((UINTN)(mRecordBuffer + sizeof (mRecordBuffer) - *Cursor) < sizeof (Present) + sizeof (Zero)) {
+    return FALSE;
+  }
+
+  BlogPut (Cursor, &Present, sizeof (Present));
+  return BlogPut (Cursor, (Data != NULL) ? Data : Zero, sizeof (Zero));
+}
+
+
+/**
+  Adds data to the ring that holds the log in its format: the
+  log table's own ring if it has one and the formats match, or
+  else the ring that is written to the log file.
+
+  @param[in] Binary       Whether Data is binary records or text.
+  @param[in] Data         Data to be logged.
+  @param[in] Length       Number of bytes in Data.
+
+**/
+VOID
+LogPut (
+  IN  BOOLEAN       Binary,
+  IN  CONST CHAR8   *Data,
+  IN  UINTN         Length
+  )
+{
+  UINTN   Offset;
+  UINTN   Part;
+
+  if ((Data == NULL) || (Length == 0)) {
+    return;
+  }
+
+  //
+  // Nothing is ever flushed from the table's own ring,
+  // the oldest data is simply overwritten.
+  //
+  if ((mTableRing.Buffer != NULL) && (Binary == mTableBinary)) {
+    if (Length > mTableRing.Size) {
+      mTableRing.Dropped += Length - mTableRing.Size;
+      Data               += Length - mTableRing.Size;
+      Length              = mTableRing.Size;
+    }
+    Offset = (UINTN)(mTableRing.Head % mTableRing.Size);
+    Part   = MIN (Length, mTableRing.Size - Offset);
+    CopyMem (mTableRing.Buffer + Offset, Data, Part);
+    CopyMem (mTableRing.Buffer, Data + Part, Length - Part);
+    mTableRing.Head += Length;
+    return;
+  }
+
+  if (mLogRing.Buffer == NULL) {
+    mLogRing.Buffer = AllocatePool (LOG_BUFFER_SIZE);
+    if (mLogRing.Buffer == NULL) {
+      return;
+    }
+    mLogRing.Size = LOG_BUFFER_SIZE;
+  }
+
+  // Keep only the tail of messages longer than the whole buffer.
+  if (Length > mLogRing.Size) {
+    mLogRing.Dropped += Length - mLogRing.Size;
+    Data             += Length - mLogRing.Size;
+    Length            = mLogRing.Size;
+  }
+
+  if ((mLogRing.Head - mLogRing.Flushed) + Length > mLogRing.Size) {
+    LogFlush ();
+  }
+
+  // Still no room, the oldest pending data has to go.
+  if ((mLogRing.Head - mLogRing.Flushed) + Length > mLogRing.Size) {
+    mLogRing.Dropped += (mLogRing.Head - mLogRing.Flushed) + Length - mLogRing.Size;
+    mLogRing.Flushed  = mLogRing.Head + Length - mLogRing.Size;
+  }
+
+  Offset = (UINTN)(mLogRing.Head % mLogRing.Size);
+  Part   = MIN (Length, mLogRing.Size - Offset);
+  CopyMem (mLogRing.Buffer + Offset, Data, Part);
+  CopyMem (mLogRing.Buffer, Data + Part, Length - Part);
+  mLogRing.Head += Length;
+}
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Opens the log file, creating and preallocating it if it does
+  not exist yet or does not have the expected layout. An existing
+  log file is kept and appended to in place, so no clusters are
+  freed or allocated on the ESP from one boot to the next.
+
+  @param[in] VolumeRoot   Root of the volume holding the log file.
+  @param[in] FilePath     Path to the log file.
+
+  @retval EFI_SUCCESS     The log file is open and mLogFileHandle set.
+  @retval other           The log file could not be opened.
+
+**/
+EFI_STATUS
+LogOpen (
+  IN  EFI_FILE_HANDLE   VolumeRoot,
+  IN  CHAR16            *FilePath
+  )
+{
+  EFI_STATUS        Status;
+  EFI_FILE_HANDLE   File;
+  EFI_FILE_INFO     *FileInfo;
+  UINTN             Size;
+
+  if ((VolumeRoot == NULL) || (FilePath == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = VolumeRoot->Open (
+                         VolumeRoot,
+                         &File,
+                         FilePath,
+                         EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE,
+                         0);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  FileInfo = GetFileInfo (File);
+  if ((FileInfo == NULL) || ((FileInfo->Attribute & EFI_FILE_DIRECTORY) != 0)) {
+    Status = EFI_ACCESS_DENIED;
+    goto Exit;
+  }
+
+  //
+  // Reuse the file as it is if it has been set up by a previous boot.
+  //
+  Size = sizeof (LOG_FILE_HEADER);
+  if ((FileInfo->FileSize != LOG_FILE_SIZE)
+    || EFI_ERROR (File->Read (File, &Size, &mLogFileHeader))
+    || (Size != sizeof (LOG_FILE_HEADER))
+    || (mLogFileHeader.Signature != LOG_FILE_SIGNATURE)
+    || (mLogFileHeader.Version != LOG_FILE_VERSION)
+    || (mLogFileHeader.DataOffset != LOG_FILE_DATA)
+    || (mLogFileHeader.DataSize != LOG_FILE_SIZE - LOG_FILE_DATA)
+    || (mLogFileHeader.WriteOffset >= mLogFileHeader.DataSize)
+    )
+  {
+    ZeroMem (&mLogFileHeader, sizeof (LOG_FILE_HEADER));
+    mLogFileHeader.Signature  = LOG_FILE_SIGNATURE;
+    mLogFileHeader.Version    = LOG_FILE_VERSION;
+    mLogFileHeader.DataOffset = LOG_FILE_DATA;
+    mLogFileHeader.DataSize   = LOG_FILE_SIZE - LOG_FILE_DATA;
+
+    if (FileInfo->FileSize != LOG_FILE_SIZE) {
+      FileInfo->FileSize = LOG_FILE_SIZE;
+      Status = File->SetInfo (File, &gEfiFileInfoGuid, (UINTN)FileInfo->Size, FileInfo);
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+    }
+  }
+
+  mLogFileHeader.BootSequence++;
+  mLogFileHandle = File;
+  UpdateDirectoryCache (FilePath, FileInfo);
+
+  Exit:
+
+  if (FileInfo != NULL) {
+    FreePool (FileInfo);
+  }
+  if (EFI_ERROR (Status)) {
+    File->Close (File);
+  }
+
+  return Status;
+}
+
+
+/**
+  Publishes the log ring, boot phase timings and the installation
+  result as a configuration table, so that a shell or diagnostic
+  tool started afterwards can read them without any disk access.
+  The table lives in ACPI reclaim memory and is kept up to date
+  whenever the log is flushed.
+
+  The table normally takes over the ring that is also written to
+  the log file. If the log file is in the other format, the table
+  gets a ring of its own instead, and only records in its format
+  end up there. A binary ring of its own starts with the header.
+
+  @param[in] Binary       Whether the table holds binary records.
+  @param[in] OwnRing      Whether the table needs a ring of its own.
+
+  @retval EFI_SUCCESS     The log table has been installed.
+  @retval other           The log table could not be allocated or installed.
+
+**/
+EFI_STATUS
+LogTableInstall (
+  IN  BOOLEAN   Binary,
+  IN  BOOLEAN   OwnRing
+  )
+{
+  EFI_STATUS  Status;
+  LOG_TABLE   *Table;
+
+  if (mLogTable != NULL) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  Status = gBS->AllocatePool (EfiACPIReclaimMemory, sizeof (LOG_TABLE) + LOG_BUFFER_SIZE, (VOID **)&Table);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ZeroMem (Table, sizeof (LOG_TABLE));
+  Table->Signature  = LOG_TABLE_SIGNATURE;
+  Table->Version    = LOG_TABLE_VERSION;
+  Table->HeaderSize = sizeof (LOG_TABLE);
+  Table->Format     = Binary ? LOG_TABLE_FORMAT_BINARY : LOG_TABLE_FORMAT_TEXT;
+  Table->Result     = EFI_NOT_STARTED;
+  Table->PhaseCount = MIN (PhaseMax, LOG_TABLE_MAX_PHASES);
+  Table->LogOffset  = sizeof (LOG_TABLE);
+  Table->LogSize    = LOG_BUFFER_SIZE;
+
+  Status = gBS->InstallConfigurationTable (&gUefiSevenLogTableGuid, Table);
+  if (EFI_ERROR (Status)) {
+    FreePool (Table);
+    return Status;
+  }
+
+  mLogTable    = Table;
+  mTableBinary = Binary;
+
+  if (OwnRing) {
+    mTableRing.Buffer = (CHAR8 *)Table + Table->LogOffset;
+    mTableRing.Size   = LOG_BUFFER_SIZE;
+    if (Binary) {
+      LogAppendBinaryHeader ();
+    }
+  } else {
+    //
+    // The ring itself becomes part of the table, carry over
+    // anything logged so far.
+    //
+    if (mLogRing.Buffer != NULL) {
+      CopyMem ((UINT8 *)Table + Table->LogOffset, mLogRing.Buffer, mLogRing.Size);
+      FreePool (mLogRing.Buffer);
+    }
+    mLogRing.Buffer = (CHAR8 *)Table + Table->LogOffset;
+    mLogRing.Size   = LOG_BUFFER_SIZE;
+  }
+
+  LogTableUpdate ();
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Records the outcome of the Int10h shim installation in the
+  published log table, if there is one.
+
+  @param[in] Result       EFI_SUCCESS if an Int10h handler is in place.
+
+**/
+VOID
+LogTableSetResult (
+  IN  EFI_STATUS  Result
+  )
+{
+  if (mLogTable != NULL) {
+    mLogTable->Result = Result;
+  }
+}
+
+
+/**
+  Returns how many times the current log file has been opened,
+  including this boot.
+
+  @retval UINT32          Boot sequence number, 0 if no log file is open.
+
+**/
+UINT32
+LogBootSequence (
+  VOID
+  )
+{
+  return (mLogFileHandle != NULL) ? mLogFileHeader.BootSequence : 0;
+}
+
+
+/**
+  Adds text to the in-memory log. Nothing is written to disk
+  here unless the buffer is full, in which case all pending data
+  is written out in one go. If the log file is not open yet,
+  the oldest data is overwritten instead.
+
+  @param[in] Data         Text to be logged.
+  @param[in] Length       Number of bytes in Data.
+
+**/
+VOID
+LogAppend (
+  IN  CONST CHAR8   *Data,
+  IN  UINTN         Length
+  )
+{
+  LogPut (FALSE, Data, Length);
+}
+
+
+/**
+  Starts a binary log. Must be the first thing logged to a ring
+  that holds binary records, as BlogDecode.py skips anything
+  before the header.
+
+**/
+VOID
+LogAppendBinaryHeader (
+  VOID
+  )
+{
+  BLOG_HEADER   Header;
+
+  Header.Signature  = BLOG_SIGNATURE;
+  Header.Version    = BLOG_VERSION;
+  Header.HeaderSize = sizeof (BLOG_HEADER);
+  Header.ImageBase  = (mUefiSevenImageInfo != NULL) ? (UINTN)mUefiSevenImageInfo->ImageBase : 0;
+
+  LogPut (TRUE, (CONST CHAR8 *)&Header, sizeof (Header));
+}
+
+
+/**
+  Logs a message as a binary record. Only the arguments are
+  captured, the format string is walked just far enough to know
+  their types; the text is produced on the host by BlogDecode.py.
+
+  @param[in] IsError      Whether this is an error message.
+  @param[in] FuncName     Name of the function logging the message.
+  @param[in] FormatString PrintLib format string of the message.
+  @param[in] Marker       Arguments for FormatString.
+
+**/
+VOID
+LogAppendBinary (
+  IN  BOOLEAN         IsError,
+  IN  CONST CHAR8     *FuncName,
+  IN  CONST CHAR16    *FormatString,
+  IN  VA_LIST         Marker
+  )
+{
+  BLOG_RECORD     *Record;
+  UINT8           *Cursor;
+  CONST CHAR16    *Format;
+  BOOLEAN         Long;
+  BOOLEAN         Fits;
+  UINT64          Value;
+
+  if ((mUefiSevenImageInfo == NULL) || (FuncName == NULL) || (FormatString == NULL)) {
+    return;
+  }
+
+  Record              = (BLOG_RECORD *)mRecordBuffer;
+  Record->Type        = IsError ? BLOG_TYPE_ERROR : BLOG_TYPE_DEBUG;
+  Record->Reserved    = 0;
+  Record->FormatRva   = BlogImageOffset (FormatString);
+  Record->FuncNameRva = BlogImageOffset (FuncName);
+  Record->Tsc         = AsmReadTsc ();
+  Cursor              = (UINT8 *)(Record + 1);
+  Fits                = TRUE;
+
+  for (Format = FormatString; Fits && (*Format != L'\0'); Format++) {
+    if (*Format != L'%') {
+      continue;
+    }
+
+    //
+    // Skip flags, width and precision, picking up '*' arguments.
+    //
+    Long = FALSE;
+    for (Format++; *Format != L'\0'; Format++) {
+      if (*Format == L'*') {
+        Value = VA_ARG (Marker, UINTN);
+        Fits  = Fits && BlogPut (&Cursor, &Value, sizeof (Value));
+      } else if ((*Format == L'l') || (*Format == L'L')) {
+        Long = TRUE;
+      } else if ((*Format != L'-') && (*Format != L'+') && (*Format != L' ') && (*Format != L',')
+        && (*Format != L'.') && ((*Format < L'0') || (*Format > L'9'))
+        )
+      {
+        break;
+      }
+    }
+
+    switch (*Format) {
+      case L'd':
+      case L'x':
+      case L'X':
+      case L'u':
+        Value = Long ? VA_ARG (Marker, UINT64) : (UINT64)(INT64)VA_ARG (Marker, int);
+        Fits  = BlogPut (&Cursor, &Value, sizeof (Value));
+        break;
+      case L'p':
+        Value = (UINTN)VA_ARG (Marker, VOID *);
+        Fits  = BlogPut (&Cursor, &Value, sizeof (Value));
+        break;
+      case L'c':
+      case L'r':
+        Value = VA_ARG (Marker, UINTN);
+        Fits  = BlogPut (&Cursor, &Value, sizeof (Value));
+        break;
+      case L's':
+      case L'S':
+        Fits  = BlogPutString (&Cursor, VA_ARG (Marker, CHAR16 *), TRUE);
+        break;
+      case L'a':
+        Fits  = BlogPutString (&Cursor, VA_ARG (Marker, CHAR8 *), FALSE);
+        break;
+      case L'g':
+      case L't':
+        Fits  = BlogPutBlob16 (&Cursor, VA_ARG (Marker, VOID *));
+        break;
+      case L'\0':
+        Format--;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (!Fits) {
+    Record->Type |= BLOG_FLAG_TRUNCATED;
+  }
+  Record->Size = (UINT16)(Cursor - mRecordBuffer);
+
+  LogPut (TRUE, (CONST CHAR8 *)mRecordBuffer, Record->Size);
+}
+
+
+/**
+  Records how many TSC ticks elapse in a known amount of time,
+  so that the host decoder can turn record timestamps into
+  milliseconds.
+
+  @param[in] Ticks        Number of TSC ticks.
+  @param[in] Microseconds Time that elapsed during Ticks.
+
+**/
+VOID
+LogAppendCalibration (
+  IN  UINT64  Ticks,
+  IN  UINT64  Microseconds
+  )
+{
+  BLOG_RECORD   *Record;
+  UINT8         *Cursor;
+
+  Record              = (BLOG_RECORD *)mRecordBuffer;
+  Record->Type        = BLOG_TYPE_CALIBRATION;
+  Record->Reserved    = 0;
+  Record->FormatRva   = 0;
+  Record->FuncNameRva = 0;
+  Record->Tsc         = AsmReadTsc ();
+  Cursor              = (UINT8 *)(Record + 1);
+
+  BlogPut (&Cursor, &Ticks, sizeof (Ticks));
+  BlogPut (&Cursor, &Microseconds, sizeof (Microseconds));
+  Record->Size = (UINT16)(Cursor - mRecordBuffer);
+
+  LogPut (TRUE, (CONST CHAR8 *)mRecordBuffer, Record->Size);
+}
+
+
+/**
+  Writes all pending log data to the log file, followed by the
+  updated log file header and a single flush, if the log file
+  is open. The published log table is refreshed as well.
+
+**/
+VOID
+LogFlush (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Offset;
+  UINTN       Pending;
+  UINTN       Part;
+
+  LogTableUpdate ();
+
+  if ((mLogFileHandle == NULL) || (mLogRing.Buffer == NULL) || (mLogRing.Head == mLogRing.Flushed)) {
+    return;
+  }
+
+  PhaseBegin (PhaseLogFlush);
+
+  Offset  = (UINTN)(mLogRing.Flushed % mLogRing.Size);
+  Pending = (UINTN)(mLogRing.Head - mLogRing.Flushed);
+  Part    = MIN (Pending, mLogRing.Size - Offset);
+
+  Status = LogWriteChunk (Offset, Part);
+  if (!EFI_ERROR (Status)) {
+    Status = LogWriteChunk (0, Pending - Part);
+  }
+  LogFileWriteAt (0, &mLogFileHeader, sizeof (LOG_FILE_HEADER));
+  mLogFileHandle->Flush (mLogFileHandle);
+
+  // Whatever could not be written will not be retried.
+  if (EFI_ERROR (Status)) {
+    mLogRing.Dropped += Pending;
+  }
+  mLogRing.Flushed = mLogRing.Head;
+
+  PhaseEnd (PhaseLogFlush);
+}
+
+
+/**
+  Releases the log buffer. Any data not flushed yet is lost,
+  except from a published log table, which stays in place.
+
+**/
+VOID
+LogFree (
+  VOID
+  )
+{
+  if (mLogTable != NULL) {
+    LogTableUpdate ();
+  }
+  if ((mLogRing.Buffer != NULL) && ((mLogTable == NULL) || (mTableRing.Buffer != NULL))) {
+    FreePool (mLogRing.Buffer);
+  }
+
+  mLogTable = NULL;
+  ZeroMem (&mLogRing, sizeof (LOG_RING));
+  ZeroMem (&mTableRing, sizeof (LOG_RING));
+}
@@ -0,0 +1,235 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __LOG_H
+#define __LOG_H
+
+
+/**
+  -----------------------------------------------------------------------------
+  Constants.
+  -----------------------------------------------------------------------------
+**/
+
+#define LOG_BUFFER_SIZE     SIZE_64KB
+
+#define LOG_FILE_SIGNATURE  SIGNATURE_32 ('U', '7', 'L', 'F')
+#define LOG_FILE_VERSION    1
+#define LOG_FILE_SIZE       SIZE_256KB
+#define LOG_FILE_DATA       512
+
+#define LOG_TABLE_SIGNATURE     SIGNATURE_32 ('U', '7', 'L', 'T')
+#define LOG_TABLE_VERSION       1
+#define LOG_TABLE_MAX_PHASES    32
+#define LOG_TABLE_FORMAT_TEXT   0
+#define LOG_TABLE_FORMAT_BINARY 1
+
+#define BLOG_SIGNATURE      SIGNATURE_64 ('U', '7', 'B', 'L', 'O', 'G', 0, 0)
+#define BLOG_VERSION        1
+#define BLOG_RECORD_MAX     512
+
+#define BLOG_TYPE_DEBUG         0
+#define BLOG_TYPE_ERROR         1
+#define BLOG_TYPE_CALIBRATION   2
+#define BLOG_FLAG_TRUNCATED     BIT7
+
+
+
+/**
+  -----------------------------------------------------------------------------
+  Includes.
+  -----------------------------------------------------------------------------
+**/
+
+#include <Uefi.h>
+
+#include <Protocol/LoadedImage.h>
+#include <Protocol/SimpleFileSystem.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+
+/**
+  -----------------------------------------------------------------------------
+  Type definitions and enums.
+  -----------------------------------------------------------------------------
+**/
+
+//
+// Head and Flushed count bytes ever appended and written out,
+// their difference is what is still pending in Buffer.
+//
+typedef struct {
+  CHAR8     *Buffer;
+  UINTN     Size;
+  UINT64    Head;
+  UINT64    Flushed;
+  UINT64    Dropped;
+} LOG_RING;
+
+//
+// Log files are preallocated once and then overwritten in place as
+// a circular log. LOG_FILE_DATA bytes are reserved for this header,
+// log data fills the rest of the file. Until the data area has
+// wrapped around, only [0, WriteOffset) of it is valid.
+//
+#pragma pack(1)
+typedef struct {
+  UINT32    Signature;
+  UINT32    Version;
+  UINT32    DataOffset;
+  UINT32    DataSize;
+  UINT32    WriteOffset;
+  UINT32    BootSequence;
+  BOOLEAN   Wrapped;
+  UINT8     Reserved[7];
+} LOG_FILE_HEADER;
+#pragma pack()
+
+//
+// Published through the EFI configuration table under
+// gUefiSevenLogTableGuid, so that whatever runs after UefiSeven
+// can read the log without touching the disk. The log ring follows
+// the header at LogOffset; once LogHead exceeds LogSize it has
+// wrapped and the oldest byte is at LogHead % LogSize.
+//
+#pragma pack(1)
+typedef struct {
+  UINT64    Ticks;
+  UINT32    Count;
+  UINT32    Reserved;
+} LOG_TABLE_PHASE;
+
+typedef struct {
+  UINT32            Signature;
+  UINT32            Version;
+  UINT32            HeaderSize;
+  UINT32            Format;                 // LOG_TABLE_FORMAT_*
+  UINT64            Result;                 // EFI_STATUS of the shim installation
+  UINT64            EntryTsc;
+  UINT64            UpdateTsc;
+  UINT64            CalibrationTicks;       // per TIMING_CALIBRATION_US, 0 if unknown
+  UINT32            PhaseCount;
+  UINT32            Reserved;
+  LOG_TABLE_PHASE   Phases[LOG_TABLE_MAX_PHASES];
+  UINT64            LogHead;
+  UINT32            LogOffset;
+  UINT32            LogSize;
+} LOG_TABLE;
+#pragma pack()
+
+//
+// Binary log (UefiSeven.blog) layout, decoded on the host by
+// BlogDecode.py. Format strings and function names are not stored,
+// only their offsets within the UefiSeven image, followed by the raw
+// arguments: UINT64 for numbers, UINT16 length + ASCII for %s/%a,
+// UINT8 present flag + 16 bytes for %g/%t.
+//
+#pragma pack(1)
+typedef struct {
+  UINT64    Signature;
+  UINT32    Version;
+  UINT32    HeaderSize;
+  UINT64    ImageBase;
+} BLOG_HEADER;
+
+typedef struct {
+  UINT16    Size;                 // including arguments
+  UINT8     Type;                 // BLOG_TYPE_* | BLOG_FLAG_*
+  UINT8     Reserved;
+  UINT32    FormatRva;
+  UINT32    FuncNameRva;
+  UINT64    Tsc;
+} BLOG_RECORD;
+#pragma pack()
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method signatures.
+  -----------------------------------------------------------------------------
+**/
+
+EFI_STATUS
+LogOpen (
+  IN  EFI_FILE_HANDLE   VolumeRoot,
+  IN  CHAR16            *FilePath
+  );
+
+EFI_STATUS
+LogTableInstall (
+  IN  BOOLEAN   Binary,
+  IN  BOOLEAN   OwnRing
+  );
+
+VOID
+LogTableSetResult (
+  IN  EFI_STATUS  Result
+  );
+
+UINT32
+LogBootSequence (
+  VOID
+  );
+
+VOID
+LogAppend (
+  IN  CONST CHAR8   *Data,
+  IN  UINTN         Length
+  );
+
+VOID
+LogAppendBinaryHeader (
+  VOID
+  );
+
+VOID
+LogAppendBinary (
+  IN  BOOLEAN         IsError,
+  IN  CONST CHAR8     *FuncName,
+  IN  CONST CHAR16    *FormatString,
+  IN  VA_LIST         Marker
+  );
+
+VOID
+LogAppendCalibration (
+  IN  UINT64  Ticks,
+  IN  UINT64  Microseconds
+  );
+
+VOID
+LogFlush (
+  VOID
+  );
+
+VOID
+LogFree (
+  VOID
+  );
+
+
+/**
+  -----------------------------------------------------------------------------
+  Imported global variables.
+  -----------------------------------------------------------------------------
+**/
+
+extern EFI_FILE_HANDLE              mLogFileHandle;
+extern EFI_LOADED_IMAGE_PROTOCOL    *mUefiSevenImageInfo;
+
+
+#endif
@@ -0,0 +1,505 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "Mtrr.h"
+#include "Display.h"
+#include "Util.h"
+
+
+/**
+  -----------------------------------------------------------------------------
+  Variables.
+  -----------------------------------------------------------------------------
+**/
+
+//
+// Memory type changes queued so far. They are only written to the
+// boot processor when something needs to take effect right away, and
+// to all processors once before Windows is launched, each time on
+// top of the MTRRs as they are by then, so that changes made by the
+// firmware in the meantime are kept.
+//
+STATIC MTRR_QUEUED_RANGE      mMtrrQueue[MTRR_QUEUE_SIZE];
+STATIC UINTN                  mMtrrQueueCount     = 0;
+STATIC MTRR_SETTINGS          mMtrrSettings;
+STATIC BOOLEAN                mMtrrBspPending     = FALSE;
+STATIC BOOLEAN                mMtrrApsPending     = FALSE;
+STATIC EFI_PHYSICAL_ADDRESS   mFrameBufferBase    = 0;
+
+
+/**
+  -----------------------------------------------------------------------------
+  Local method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Returns the MTRR layout the queued changes lead to: the current
+  MTRRs of the boot processor with every queued range applied on
+  top, in the order they were queued.
+
+  @retval MTRR_SETTINGS*  The MTRR layout.
+
+**/
+MTRR_SETTINGS *
+MtrrLoadSettings (
+  VOID
+  )
+{
+  RETURN_STATUS   Status;
+  UINTN           Index;
+
+  MtrrGetAllMtrrs (&mMtrrSettings);
+  for (Index = 0; Index < mMtrrQueueCount; Index++) {
+    Status = MtrrSetMemoryAttributeInMtrrSettings (
+               &mMtrrSettings,
+               mMtrrQueue[Index].BaseAddress,
+               mMtrrQueue[Index].Length,
+               mMtrrQueue[Index].Type);
+    if (RETURN_ERROR (Status)) {
+      PrintDebug (L"MTRRs for %lx-%lx can no longer be set to %s (error: %r)\n",
+        mMtrrQueue[Index].BaseAddress,
+        mMtrrQueue[Index].BaseAddress + mMtrrQueue[Index].Length - 1,
+        MtrrCacheTypeName (mMtrrQueue[Index].Type),
+        (EFI_STATUS)Status);
+    }
+  }
+
+  return &mMtrrSettings;
+}
+
+
+/**
+  Programs the MTRRs of the processor it runs on from a buffer.
+  Runs on the application processors through StartupAllAPs.
+
+  @param[in] Buffer       The MTRR_SETTINGS to apply.
+
+**/
+VOID
+EFIAPI
+MtrrApplySettings (
+  IN  VOID  *Buffer
+  )
+{
+  MtrrSetAllMtrrs ((MTRR_SETTINGS *)Buffer);
+}
+
+
+/**
+  Counts the variable MTRRs needed to cover a range on its own,
+  ie. the number of naturally aligned power-of-two blocks it
+  splits into.
+
+  @param[in] BaseAddress  Start of the range, 4 KiB aligned.
+  @param[in] Length       Length of the range, 4 KiB aligned.
+
+  @retval UINT32          Number of variable MTRRs.
+
+**/
+UINT32
+CountVariableMtrrsNeeded (
+  IN  UINT64  BaseAddress,
+  IN  UINT64  Length
+  )
+{
+  UINT64  Block;
+  UINT32  Count;
+
+  for (Count = 0; Length > 0; Count++) {
+    Block = GetPowerOfTwo64 (Length);
+    if (BaseAddress != 0) {
+      Block = MIN (Block, LShiftU64 (1, (UINTN)LowBitSet64 (BaseAddress)));
+    }
+    BaseAddress += Block;
+    Length      -= Block;
+  }
+
+  return Count;
+}
+
+
+/**
+  Inspects the variable MTRRs currently programmed on this CPU.
+
+  @param[in] Settings     MTRRs as returned by MtrrGetAllMtrrs.
+  @param[in] BaseAddress  Start of the range to check.
+  @param[in] Length       Length of the range to check.
+  @param[out] Used        Number of variable MTRRs in use.
+
+  @retval TRUE            A variable MTRR other than UC partially
+                          overlaps the range. Adding a WC range
+                          would leave parts of it with an undefined
+                          memory type.
+  @retval FALSE           No conflicting variable MTRR.
+
+**/
+BOOLEAN
+FindConflictingMtrr (
+  IN  CONST MTRR_SETTINGS   *Settings,
+  IN  UINT64                BaseAddress,
+  IN  UINT64                Length,
+  OUT UINT32                *Used
+  )
+{
+  UINT32    Index;
+  UINT32    Count;
+  UINT64    MtrrBase;
+  UINT64    MtrrLength;
+  BOOLEAN   Conflict;
+
+  Count     = GetVariableMtrrCount ();
+  *Used     = 0;
+  Conflict  = FALSE;
+
+  for (Index = 0; (Index < Count) && (Index < MTRR_NUMBER_OF_VARIABLE_MTRR); Index++) {
+    if ((Settings->Variables.Mtrr[Index].Mask & MTRR_VARIABLE_VALID) == 0) {
+      continue;
+    }
+    (*Used)++;
+
+    MtrrBase   = Settings->Variables.Mtrr[Index].Base & ~((UINT64)SIZE_4KB - 1);
+    MtrrLength = LShiftU64 (1, (UINTN)LowBitSet64 (Settings->Variables.Mtrr[Index].Mask & ~((UINT64)SIZE_4KB - 1)));
+    if ((MtrrBase >= BaseAddress + Length) || (MtrrBase + MtrrLength <= BaseAddress)) {
+      continue;
+    }
+
+    PrintDebug (L"Variable MTRR %u (%lx, %lx, %s) overlaps the framebuffer\n", Index, MtrrBase, MtrrLength,
+      MtrrCacheTypeName ((MTRR_MEMORY_CACHE_TYPE)(Settings->Variables.Mtrr[Index].Base & MTRR_VARIABLE_TYPE_MASK)));
+
+    // Covering the whole framebuffer is fine, MtrrLib carves it up.
+    if ((MtrrBase <= BaseAddress) && (MtrrBase + MtrrLength >= BaseAddress + Length)) {
+      continue;
+    }
+    if ((Settings->Variables.Mtrr[Index].Base & MTRR_VARIABLE_TYPE_MASK) != CacheUncacheable) {
+      Conflict = TRUE;
+    }
+  }
+
+  return Conflict;
+}
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Returns a printable name for an MTRR memory type.
+
+  @param[in] Type         The memory type.
+
+  @retval CONST CHAR16*   Its name.
+
+**/
+CONST CHAR16 *
+MtrrCacheTypeName (
+  IN  MTRR_MEMORY_CACHE_TYPE  Type
+  )
+{
+  switch (Type) {
+    case CacheUncacheable:
+      return L"UC";
+    case CacheWriteCombining:
+      return L"WC";
+    case CacheWriteThrough:
+      return L"WT";
+    case CacheWriteProtected:
+      return L"WP";
+    case CacheWriteBack:
+      return L"WB";
+    default:
+      return L"invalid";
+  }
+}
+
+
+/**
+  Queues a change of the memory type of a range, without touching
+  any processor yet. A change of the very same range replaces the
+  one queued before. See MtrrCommit.
+
+  @param[in] BaseAddress  Start of the range.
+  @param[in] Length       Length of the range.
+  @param[in] Type         The new memory type.
+
+  @retval EFI_SUCCESS     The layout has been updated.
+  @retval EFI_UNSUPPORTED MTRRs are not supported.
+  @retval EFI_OUT_OF_RESOURCES  Too many ranges are queued already.
+  @retval other           The range could not be expressed in MTRRs,
+                          nothing has been queued.
+
+**/
+EFI_STATUS
+MtrrQueueMemoryAttribute (
+  IN  EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN  UINT64                  Length,
+  IN  MTRR_MEMORY_CACHE_TYPE  Type
+  )
+{
+  RETURN_STATUS   Status;
+  UINTN           Index;
+
+  if (!IsMtrrSupported ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  // Make sure it fits in with everything else first.
+  Status = MtrrSetMemoryAttributeInMtrrSettings (MtrrLoadSettings (), BaseAddress, Length, Type);
+  if (RETURN_ERROR (Status)) {
+    return (EFI_STATUS)Status;
+  }
+
+  for (Index = 0; Index < mMtrrQueueCount; Index++) {
+    if ((mMtrrQueue[Index].BaseAddress == BaseAddress) && (mMtrrQueue[Index].Length == Length)) {
+      mMtrrQueueCount--;
+      CopyMem (&mMtrrQueue[Index], &mMtrrQueue[Index + 1], (mMtrrQueueCount - Index) * sizeof (MTRR_QUEUED_RANGE));
+      break;
+    }
+  }
+  if (mMtrrQueueCount == MTRR_QUEUE_SIZE) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mMtrrQueue[mMtrrQueueCount].BaseAddress = BaseAddress;
+  mMtrrQueue[mMtrrQueueCount].Length      = Length;
+  mMtrrQueue[mMtrrQueueCount].Type        = Type;
+  mMtrrQueueCount++;
+
+  mMtrrBspPending = TRUE;
+  mMtrrApsPending = TRUE;
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Applies the queued changes on top of the current MTRRs of the boot
+  processor, and optionally writes the result to all application
+  processors, each in a single pass, so that every processor flushes
+  its caches and reloads its MTRRs only once. Processors that are
+  already up to date are skipped.
+
+  @param[in] AllProcessors  Whether the application processors are
+                            to be updated as well.
+
+  @retval EFI_SUCCESS       The requested processors are up to date.
+  @retval other             The application processors could not
+                            be updated.
+
+**/
+EFI_STATUS
+MtrrCommit (
+  IN  BOOLEAN   AllProcessors
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+
+  if (mMtrrBspPending) {
+    MtrrSetAllMtrrs (MtrrLoadSettings ());
+    mMtrrBspPending = FALSE;
+  }
+
+  if (!AllProcessors || !mMtrrApsPending) {
+    return EFI_SUCCESS;
+  }
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->StartupAllAPs (MpServices, MtrrApplySettings, FALSE, NULL, 0, MtrrLoadSettings (), NULL);
+    // No application processors to update.
+    if (Status == EFI_NOT_STARTED) {
+      Status = EFI_SUCCESS;
+    }
+  }
+  mMtrrApsPending = FALSE;
+
+  PrintDebug (L"MTRRs updated on application processors (status: %r)\n", Status);
+  if (mFrameBufferBase != 0) {
+    PrintDebug (L"Framebuffer at %lx is now %s\n", mFrameBufferBase, MtrrCacheTypeName (MtrrGetMemoryAttribute (mFrameBufferBase)));
+  }
+
+  return Status;
+}
+
+
+/**
+  Returns the memory type of a range on the boot processor, checking
+  every 4 KiB page of it.
+
+  @param[in] BaseAddress  Start of the range.
+  @param[in] Length       Length of the range.
+
+  @retval MTRR_MEMORY_CACHE_TYPE  The memory type of the whole range,
+                                  or CacheInvalid if it is mixed.
+
+**/
+MTRR_MEMORY_CACHE_TYPE
+MtrrGetRangeType (
+  IN  EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN  UINT64                  Length
+  )
+{
+  MTRR_MEMORY_CACHE_TYPE  Type;
+  UINT64                  Offset;
+
+  Type = MtrrGetMemoryAttribute (BaseAddress);
+  for (Offset = SIZE_4KB; Offset < Length; Offset += SIZE_4KB) {
+    if (MtrrGetMemoryAttribute (BaseAddress + Offset) != Type) {
+      return CacheInvalid;
+    }
+  }
+
+  return Type;
+}
+
+
+/**
+  Makes sure a memory range is not left uncached, eg. because it was
+  unlocked through MTRRs and locking it again failed. Restores the
+  type the range originally had, falling back to write-back.
+
+  @param[in] BaseAddress  Start of the range.
+  @param[in] Length       Length of the range.
+  @param[in] OriginalType Type of the range before it was unlocked,
+                          CacheInvalid if unknown.
+
+  @retval EFI_SUCCESS       The range is cacheable.
+  @retval EFI_UNSUPPORTED   MTRRs are not supported.
+  @retval EFI_DEVICE_ERROR  The range is still uncached.
+
+**/
+EFI_STATUS
+EnsureCacheableMemory (
+  IN  EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN  UINT64                  Length,
+  IN  MTRR_MEMORY_CACHE_TYPE  OriginalType
+  )
+{
+  MTRR_MEMORY_CACHE_TYPE  Candidates[2];
+  MTRR_MEMORY_CACHE_TYPE  Type;
+  UINTN                   Index;
+
+  if (!IsMtrrSupported ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  MtrrCommit (FALSE);
+  Type = MtrrGetRangeType (BaseAddress, Length);
+  if ((Type != CacheUncacheable) && (Type != CacheInvalid)) {
+    PrintDebug (L"Memory at %lx is %s\n", BaseAddress, MtrrCacheTypeName (Type));
+    return EFI_SUCCESS;
+  }
+
+  Candidates[0] = OriginalType;
+  Candidates[1] = CacheWriteBack;
+
+  for (Index = 0; Index < ARRAY_SIZE (Candidates); Index++) {
+    if ((Candidates[Index] == CacheUncacheable) || (Candidates[Index] == CacheInvalid)
+      || EFI_ERROR (MtrrQueueMemoryAttribute (BaseAddress, Length, Candidates[Index]))
+      )
+    {
+      continue;
+    }
+
+    MtrrCommit (FALSE);
+    Type = MtrrGetRangeType (BaseAddress, Length);
+    PrintDebug (L"Memory at %lx set to %s, now %s\n", BaseAddress,
+      MtrrCacheTypeName (Candidates[Index]), MtrrCacheTypeName (Type));
+    if (Type == Candidates[Index]) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  PrintError (L"Memory at %lx is left %s\n", BaseAddress, MtrrCacheTypeName (Type));
+  return EFI_DEVICE_ERROR;
+}
+
+
+/**
+  Maps the GOP framebuffer as write-combining through a variable
+  MTRR, so that the Windows VGA driver, which draws everything into
+  the linear framebuffer published by the shim, does not have to go
+  through uncached writes. Nothing is changed if the range is WC
+  already, if not enough variable MTRRs are free or if an existing
+  MTRR would partially overlap it. The change is only queued, it
+  takes effect with the next MtrrCommit.
+
+  @retval EFI_SUCCESS       The framebuffer is or will be write-combining.
+  @retval EFI_UNSUPPORTED   No GOP framebuffer or no MTRR support.
+  @retval EFI_ACCESS_DENIED An existing MTRR conflicts with the framebuffer.
+  @retval other             The MTRRs could not be programmed.
+
+**/
+EFI_STATUS
+SetFrameBufferWriteCombining (
+  VOID
+  )
+{
+  EFI_STATUS              Status;
+  MTRR_MEMORY_CACHE_TYPE  Before;
+  UINT64                  BaseAddress;
+  UINT64                  Length;
+  UINT32                  Used;
+  UINT32                  Needed;
+
+  if (EFI_ERROR (EnsureDisplayAvailable ()) || (mDisplayInfo.Protocol != GOP)
+    || (mDisplayInfo.FrameBufferBase == 0) || (mDisplayInfo.FrameBufferSize == 0)
+    )
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!IsMtrrSupported ()) {
+    PrintDebug (L"MTRRs not supported, framebuffer cache type left alone\n");
+    return EFI_UNSUPPORTED;
+  }
+
+  BaseAddress = mDisplayInfo.FrameBufferBase & ~((UINT64)SIZE_4KB - 1);
+  Length      = ALIGN_VALUE (mDisplayInfo.FrameBufferBase + mDisplayInfo.FrameBufferSize, SIZE_4KB) - BaseAddress;
+
+  Before = MtrrGetMemoryAttribute (BaseAddress);
+  if (Before == CacheWriteCombining) {
+    PrintDebug (L"Framebuffer at %lx is already WC\n", BaseAddress);
+    return EFI_SUCCESS;
+  }
+
+  if (FindConflictingMtrr (MtrrLoadSettings (), BaseAddress, Length, &Used)) {
+    PrintDebug (L"Framebuffer left %s, an existing MTRR partially overlaps it\n", MtrrCacheTypeName (Before));
+    return EFI_ACCESS_DENIED;
+  }
+
+  Needed = CountVariableMtrrsNeeded (BaseAddress, Length);
+  if (Used + Needed > GetFirmwareVariableMtrrCount ()) {
+    PrintDebug (L"Framebuffer left %s, %u variable MTRRs needed but only %u of %u free\n",
+      MtrrCacheTypeName (Before), Needed, GetFirmwareVariableMtrrCount () - MIN (Used, GetFirmwareVariableMtrrCount ()),
+      GetFirmwareVariableMtrrCount ());
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = MtrrQueueMemoryAttribute (BaseAddress, Length, CacheWriteCombining);
+  if (!EFI_ERROR (Status)) {
+    mFrameBufferBase = BaseAddress;
+  }
+
+  PrintDebug (L"Framebuffer %lx-%lx cache type %s -> %s (%r)\n",
+    BaseAddress, BaseAddress + Length - 1, MtrrCacheTypeName (Before),
+    MtrrCacheTypeName (CacheWriteCombining), Status);
+
+  return Status;
+}
@@ -0,0 +1,105 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __MTRR_H
+#define __MTRR_H
+
+
+/**
+  -----------------------------------------------------------------------------
+  Constants.
+  -----------------------------------------------------------------------------
+**/
+
+#define MTRR_VARIABLE_VALID     BIT11
+#define MTRR_VARIABLE_TYPE_MASK 0xFF
+#define MTRR_QUEUE_SIZE         8
+
+
+
+/**
+  -----------------------------------------------------------------------------
+  Includes.
+  -----------------------------------------------------------------------------
+**/
+
+#include <Uefi.h>
+
+#include <Protocol/MpService.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MtrrLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+
+/**
+  -----------------------------------------------------------------------------
+  Type definitions and enums.
+  -----------------------------------------------------------------------------
+**/
+
+//
+// One memory type change queued by MtrrQueueMemoryAttribute.
+//
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    BaseAddress;
+  UINT64                  Length;
+  MTRR_MEMORY_CACHE_TYPE  Type;
+} MTRR_QUEUED_RANGE;
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method signatures.
+  -----------------------------------------------------------------------------
+**/
+
+CONST CHAR16 *
+MtrrCacheTypeName (
+  IN  MTRR_MEMORY_CACHE_TYPE  Type
+  );
+
+EFI_STATUS
+MtrrQueueMemoryAttribute (
+  IN  EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN  UINT64                  Length,
+  IN  MTRR_MEMORY_CACHE_TYPE  Type
+  );
+
+EFI_STATUS
+MtrrCommit (
+  IN  BOOLEAN   AllProcessors
+  );
+
+MTRR_MEMORY_CACHE_TYPE
+MtrrGetRangeType (
+  IN  EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN  UINT64                  Length
+  );
+
+EFI_STATUS
+EnsureCacheableMemory (
+  IN  EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN  UINT64                  Length,
+  IN  MTRR_MEMORY_CACHE_TYPE  OriginalType
+  );
+
+EFI_STATUS
+SetFrameBufferWriteCombining (
+  VOID
+  );
+
+
+#endif
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+###
+# @file
+# Prints the Int10h call counters and trace ring of the UefiSeven shim found
+# in a memory dump, for example one taken from the QEMU monitor with
+#
+#   pmemsave 0xc0000 0x10000 shim.bin
+#   ShimDecode.py shim.bin --base 0xc0000
+#
+# Dumps of the whole low memory work as well, the shim is found by its
+# signature. Only the instrumented handler (handler=trace) fills the trace
+# ring. While the shim sits in a locked VGA ROM, the current mode and the
+# call counters are kept in a page below 640 KiB instead, which has to be
+# in the dump as well, e.g. pmemsave 0 0x100000 with --base 0.
+#
+# Copyright (c) 2020, Seungjoo Kim
+#
+# This program and the accompanying materials are licensed and made available
+# under the terms and conditions of the BSD License which accompanies this
+# distribution.  The full text of the license may be found at
+# http://opensource.org/licenses/bsd-license.php
+#
+# THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS, WITHOUT
+# WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+#
+###
+
+import argparse
+import struct
+import sys
+
+# Must match UefiSeven.h.
+SHIM_SIGNATURE        = b'U7SH'
+SHIM_HEADER_OFFSET    = 0x100
+SHIM_FIRST_MODE       = 0x00F1
+SHIM_VBE_FUNCTIONS    = 0x16
+SHIM_LEGACY_FUNCTIONS = 0x20
+SHIM_HEADER           = struct.Struct('<4sHHH%dH%dHHHHHHIHHBHHH' % (SHIM_VBE_FUNCTIONS, SHIM_LEGACY_FUNCTIONS))
+SHIM_TRACE_ENTRY      = struct.Struct('<8H')
+
+VBE_FUNCTIONS = {
+    0x00: 'GetInfo', 0x01: 'GetModeInfo', 0x02: 'SetMode', 0x03: 'GetMode',
+    0x04: 'SaveRestoreState', 0x05: 'WindowControl', 0x06: 'ScanLineLength',
+    0x07: 'DisplayStart', 0x08: 'DacPaletteFormat', 0x09: 'PaletteData',
+    0x0A: 'PmInterface', 0x0B: 'PixelClock', 0x10: 'PowerManagement',
+    0x11: 'FlatPanel', 0x13: 'Audio', 0x14: 'Oem', 0x15: 'Ddc',
+}
+LEGACY_FUNCTIONS = {
+    0x00: 'SetMode', 0x01: 'SetCursorShape', 0x02: 'SetCursorPosition',
+    0x03: 'GetCursorPosition', 0x05: 'SelectPage', 0x06: 'ScrollUp',
+    0x07: 'ScrollDown', 0x08: 'ReadCharacter', 0x09: 'WriteCharacterAttribute',
+    0x0A: 'WriteCharacter', 0x0B: 'SetBorderColor', 0x0C: 'WritePixel',
+    0x0D: 'ReadPixel', 0x0E: 'TeletypeOutput', 0x0F: 'GetMode',
+    0x10: 'PaletteRegisters', 0x11: 'CharacterGenerator', 0x12: 'AlternateSelect',
+    0x13: 'WriteString', 0x1A: 'DisplayCombination', 0x1B: 'FunctionalityState',
+    0x1C: 'SaveRestoreState',
+}
+
+
+class Shim:
+    """The header fields of a shim at a given offset of the dump."""
+
+    def __init__(self, dump, offset):
+        fields = SHIM_HEADER.unpack_from(dump, offset + SHIM_HEADER_OFFSET)
+        self.offset = offset
+        (_, self.mode_count, self.mode_table, self.current_mode) = fields[:4]
+        fields = fields[4:]
+        self.vbe_hits = fields[:SHIM_VBE_FUNCTIONS]
+        fields = fields[SHIM_VBE_FUNCTIONS:]
+        self.legacy_hits = fields[:SHIM_LEGACY_FUNCTIONS]
+        fields = fields[SHIM_LEGACY_FUNCTIONS:]
+        (self.other_hits, self.trace_offset, self.trace_entries,
+         self.trace_head, _, self.trace_calls, _, _, _, _, _,
+         self.data_segment) = fields
+
+
+def find_shims(dump):
+    """Yields every plausible shim in the dump. Shims start at a paragraph
+    boundary, as the handler addresses everything relative to CS."""
+    pos = dump.find(SHIM_SIGNATURE)
+    while pos >= 0:
+        offset = pos - SHIM_HEADER_OFFSET
+        if offset >= 0 and offset % 16 == 0 and pos + SHIM_HEADER.size <= len(dump):
+            shim = Shim(dump, offset)
+            if shim.mode_table % 16 == 0 and shim.trace_head <= shim.trace_entries:
+                yield shim
+        pos = dump.find(SHIM_SIGNATURE, pos + 1)
+
+
+def shim_data(dump, shim, base):
+    """Returns the header fields the handler writes to, the current mode
+    and the call counters, or None if the page it keeps them in while the
+    VGA ROM is locked is not in the dump."""
+    offset = shim.data_segment * 16 - base
+    if offset == shim.offset:
+        return shim
+    position = offset + SHIM_HEADER_OFFSET
+    if position < 0 or position + SHIM_HEADER.size > len(dump) \
+            or dump[position:position + len(SHIM_SIGNATURE)] != SHIM_SIGNATURE:
+        return None
+    return Shim(dump, offset)
+
+
+def function_name(ax):
+    if ax >> 8 == 0x4F:
+        return '4F%02Xh %s' % (ax & 0xFF, VBE_FUNCTIONS.get(ax & 0xFF, 'Unknown'))
+    return '%02Xh %s' % (ax >> 8, LEGACY_FUNCTIONS.get(ax >> 8, 'Unknown'))
+
+
+def trace(dump, shim):
+    """Returns the recorded calls, oldest first, and how many older ones
+    have been overwritten already."""
+    recorded = min(shim.trace_calls, shim.trace_entries)
+    first = shim.trace_head if shim.trace_calls > shim.trace_entries else 0
+    entries = []
+    for i in range(recorded):
+        index = (first + i) % shim.trace_entries
+        position = shim.offset + shim.trace_offset + index * SHIM_TRACE_ENTRY.size
+        if position + SHIM_TRACE_ENTRY.size > len(dump):
+            break
+        entries.append(SHIM_TRACE_ENTRY.unpack_from(dump, position))
+    return entries, shim.trace_calls - recorded
+
+
+def decode(dump, shim, base):
+    data = shim_data(dump, shim, base)
+    lines = ['Shim at %#x: %d modes (%03Xh-%03Xh), current mode %s' % (
+        base + shim.offset, shim.mode_count, SHIM_FIRST_MODE,
+        SHIM_FIRST_MODE + shim.mode_count - 1,
+        '%04Xh' % data.current_mode if data else 'unknown')]
+
+    lines.append('')
+    lines.append('Calls per function:')
+    if not data:
+        lines.append('  unknown, they are kept at %#x, which is not in the dump' % (
+            shim.data_segment * 16 + SHIM_HEADER_OFFSET))
+    else:
+        hits = [(0x4F00 | i, n) for i, n in enumerate(data.vbe_hits) if n]
+        hits += [(i << 8, n) for i, n in enumerate(data.legacy_hits) if n]
+        for ax, n in hits:
+            lines.append('  %-28s %6d' % (function_name(ax), n))
+        if data.other_hits:
+            lines.append('  %-28s %6d' % ('other', data.other_hits))
+        if not hits and not data.other_hits:
+            lines.append('  none recorded')
+
+    lines.append('')
+    if not shim.trace_calls:
+        lines.append('No calls traced.')
+        return '\n'.join(lines) + '\n'
+    entries, lost = trace(dump, shim)
+    lines.append('Trace of %d calls%s:' % (shim.trace_calls,
+                                          ', the oldest %d overwritten' % lost if lost else ''))
+    lines.append('  %8s  %-19s  %-19s  %s' % ('#', 'AX   BX   CX   DX', 'AX   BX   CX   DX', 'function'))
+    for i, entry in enumerate(entries):
+        lines.append('  %8d  %04X %04X %04X %04X  %04X %04X %04X %04X  %s' % (
+            (lost + i + 1,) + entry + (function_name(entry[0]),)))
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode the UefiSeven Int10h shim in a memory dump.')
+    parser.add_argument('dump', help='raw memory dump, e.g. from QEMU pmemsave')
+    parser.add_argument('-b', '--base', type=lambda x: int(x, 0), default=0,
+                        help='physical address the dump starts at, needed to find the data page')
+    options = parser.parse_args()
+
+    with open(options.dump, 'rb') as f:
+        dump = f.read()
+    shims = list(find_shims(dump))
+    # The data page of a shim in a locked VGA ROM holds a copy of its header.
+    def own_data(shim):
+        return shim.data_segment * 16 - options.base == shim.offset
+    shims = [shim for shim in shims
+             if not own_data(shim) or not any(
+                 other.data_segment == shim.data_segment and not own_data(other) for other in shims)]
+    if not shims:
+        sys.exit('%s: no UefiSeven shim found' % options.dump)
+    sys.stdout.write('\n'.join(decode(dump, shim, options.base) for shim in shims))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,269 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include "Timing.h"
+#include "Log.h"
+#include "Util.h"
+
+
+/**
+  -----------------------------------------------------------------------------
+  Variables.
+  -----------------------------------------------------------------------------
+**/
+
+STATIC UINT64         mEntryTicks         = 0;
+STATIC UINT64         mCalibrationTicks   = 0;
+STATIC PHASE_TIMER    mPhaseTimers[PhaseMax];
+
+// Phases in progress, innermost last. Only the innermost one is timed.
+STATIC BOOT_PHASE     mPhaseStack[TIMING_MAX_NESTING];
+STATIC UINTN          mPhaseDepth         = 0;
+
+STATIC CONST CHAR16   *mPhaseNames[PhaseMax] = {
+  L"IVT claim",
+  L"Volume open",
+  L"Directory scan",
+  L"ReadConfig",
+  L"SwitchVideoMode",
+  L"ForceVideoModeHack",
+  L"Memory unlock",
+  L"Memory lock",
+  L"ShimVesaInformation",
+  L"MTRR update",
+  L"LoadImage",
+  L"CheckBootMgrGuid",
+  L"Waiting for user",
+  L"Log flush"
+};
+
+
+/**
+  -----------------------------------------------------------------------------
+  Local method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Measures how many TSC ticks elapse during a fixed boot services
+  stall. Only done once, and only when timings are actually reported,
+  so that normal boots do not pay for the calibration delay.
+
+**/
+VOID
+CalibrateTicks (
+  VOID
+  )
+{
+  UINT64  Start;
+
+  if (mCalibrationTicks != 0) {
+    return;
+  }
+
+  Start = AsmReadTsc ();
+  gBS->Stall (TIMING_CALIBRATION_US);
+  mCalibrationTicks = AsmReadTsc () - Start;
+}
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method implementations.
+  -----------------------------------------------------------------------------
+**/
+
+
+/**
+  Records the moment UefiSeven got control from firmware. Should be
+  the very first thing called from the entry point.
+
+**/
+VOID
+TimingInitialize (
+  VOID
+  )
+{
+  mEntryTicks = AsmReadTsc ();
+  mPhaseDepth = 0;
+  ZeroMem (mPhaseTimers, sizeof (mPhaseTimers));
+}
+
+
+/**
+  Marks the start of a boot phase. Phases may be entered more than
+  once, in which case their durations are accumulated. A phase that
+  begins while another one is in progress, e.g. a log flush while
+  the memory is being unlocked, pauses the outer phase, so that no
+  time is counted twice.
+
+  @param[in] Phase        The phase being entered.
+
+**/
+VOID
+PhaseBegin (
+  IN  BOOT_PHASE  Phase
+  )
+{
+  UINT64      Now;
+  BOOT_PHASE  Outer;
+
+  if ((Phase >= PhaseMax) || (mPhaseDepth == TIMING_MAX_NESTING)) {
+    return;
+  }
+
+  Now = AsmReadTsc ();
+  if (mPhaseDepth > 0) {
+    Outer = mPhaseStack[mPhaseDepth - 1];
+    mPhaseTimers[Outer].Ticks += Now - mPhaseTimers[Outer].StartTicks;
+  }
+
+  mPhaseStack[mPhaseDepth++]      = Phase;
+  mPhaseTimers[Phase].StartTicks  = Now;
+}
+
+
+/**
+  Marks the end of a boot phase previously started with PhaseBegin,
+  and of any phase started within it that has not ended yet. The
+  outer phase, if any, resumes.
+
+  @param[in] Phase        The phase being left.
+
+**/
+VOID
+PhaseEnd (
+  IN  BOOT_PHASE  Phase
+  )
+{
+  UINT64      Now;
+  UINTN       Depth;
+  BOOT_PHASE  Inner;
+
+  for (Depth = mPhaseDepth; Depth > 0; Depth--) {
+    if (mPhaseStack[Depth - 1] == Phase) {
+      break;
+    }
+  }
+  if (Depth == 0) {
+    return;
+  }
+
+  Now = AsmReadTsc ();
+  while (mPhaseDepth >= Depth) {
+    Inner = mPhaseStack[--mPhaseDepth];
+    mPhaseTimers[Inner].Ticks += Now - mPhaseTimers[Inner].StartTicks;
+    mPhaseTimers[Inner].Count++;
+  }
+
+  if (mPhaseDepth > 0) {
+    mPhaseTimers[mPhaseStack[mPhaseDepth - 1]].StartTicks = Now;
+  }
+}
+
+
+/**
+  Converts a TSC tick count into microseconds, calibrating
+  the TSC first if that has not been done yet.
+
+  @param[in] Ticks        Number of TSC ticks.
+
+  @retval UINT64          Number of microseconds, or 0 if
+                          the TSC could not be calibrated.
+
+**/
+UINT64
+TicksToMicroseconds (
+  IN  UINT64  Ticks
+  )
+{
+  CalibrateTicks ();
+  if (mCalibrationTicks == 0) {
+    return 0;
+  }
+
+  return (Ticks * TIMING_CALIBRATION_US) / mCalibrationTicks;
+}
+
+
+/**
+  Gives access to the raw timing data collected so far, without
+  calibrating the TSC.
+
+  @param[out] EntryTicks        TSC value when UefiSeven got control.
+  @param[out] CalibrationTicks  TSC ticks per TIMING_CALIBRATION_US,
+                                0 if not calibrated yet.
+  @param[out] PhaseTimers       Array of PhaseMax phase timers.
+
+**/
+VOID
+GetBootTimings (
+  OUT UINT64              *EntryTicks,
+  OUT UINT64              *CalibrationTicks,
+  OUT CONST PHASE_TIMER   **PhaseTimers
+  )
+{
+  *EntryTicks       = mEntryTicks;
+  *CalibrationTicks = mCalibrationTicks;
+  *PhaseTimers      = mPhaseTimers;
+}
+
+
+/**
+  Prints a summary table of time spent in each boot phase since
+  TimingInitialize was called. Output goes through PrintDebug, so
+  it is shown in verbose mode and written to the log file.
+
+**/
+VOID
+PrintBootTimings (
+  VOID
+  )
+{
+  UINTN   i;
+  UINT64  TotalTicks;
+  UINT64  PhaseTicks;
+  UINT64  Us;
+
+  if (!(mVerboseMode || mLogToFile || mLogToTable) || (mLogLevel < LOG_LEVEL_DEBUG) || (mEntryTicks == 0)) {
+    return;
+  }
+
+  TotalTicks = AsmReadTsc () - mEntryTicks;
+  PhaseTicks = 0;
+
+  CalibrateTicks ();
+  if ((mLogToFile && mBinaryLog) || (mLogToTable && mBinaryTable)) {
+    LogAppendCalibration (mCalibrationTicks, TIMING_CALIBRATION_US);
+  }
+  PrintDebug (L"Boot phase timings (%lu TSC ticks per ms):\n",
+    mCalibrationTicks / (TIMING_CALIBRATION_US / 1000));
+
+  for (i = 0; i < PhaseMax; i++) {
+    if (mPhaseTimers[i].Count == 0) {
+      continue;
+    }
+    PhaseTicks += mPhaseTimers[i].Ticks;
+    Us = TicksToMicroseconds (mPhaseTimers[i].Ticks);
+    PrintDebug (L"  %-20s %6lu.%03lu ms (%ux)\n",
+      mPhaseNames[i], Us / 1000, Us % 1000, mPhaseTimers[i].Count);
+  }
+
+  // Log flushes while printing this end after TotalTicks was taken.
+  Us = TicksToMicroseconds ((TotalTicks > PhaseTicks) ? TotalTicks - PhaseTicks : 0);
+  PrintDebug (L"  %-20s %6lu.%03lu ms\n", L"Other", Us / 1000, Us % 1000);
+  Us = TicksToMicroseconds (TotalTicks);
+  PrintDebug (L"  %-20s %6lu.%03lu ms\n", L"Total", Us / 1000, Us % 1000);
+}
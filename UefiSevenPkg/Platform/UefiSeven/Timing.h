@@ -0,0 +1,127 @@
+/** @file
+
+  Copyright (c) 2020, Seungjoo Kim
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __TIMING_H
+#define __TIMING_H
+
+
+/**
+  -----------------------------------------------------------------------------
+  Constants.
+  -----------------------------------------------------------------------------
+**/
+
+#define TIMING_CALIBRATION_US   10000
+#define TIMING_MAX_NESTING      8
+
+
+
+/**
+  -----------------------------------------------------------------------------
+  Includes.
+  -----------------------------------------------------------------------------
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+
+
+/**
+  -----------------------------------------------------------------------------
+  Type definitions and enums.
+  -----------------------------------------------------------------------------
+**/
+
+typedef enum {
+  PhaseIvtClaim,
+  PhaseVolumeOpen,
+  PhaseDirectoryScan,
+  PhaseReadConfig,
+  PhaseSwitchVideoMode,
+  PhaseForceVideoModeHack,
+  PhaseMemoryUnlock,
+  PhaseMemoryLock,
+  PhaseShimVesaInformation,
+  PhaseMtrrUpdate,
+  PhaseLoadImage,
+  PhaseCheckBootMgrGuid,
+  PhaseWaitForUser,
+  PhaseLogFlush,
+  PhaseMax
+} BOOT_PHASE;
+
+typedef struct {
+  UINT64    Ticks;
+  UINT64    StartTicks;
+  UINT32    Count;
+} PHASE_TIMER;
+
+
+/**
+  -----------------------------------------------------------------------------
+  Exported method signatures.
+  -----------------------------------------------------------------------------
+**/
+
+VOID
+TimingInitialize (
+  VOID
+  );
+
+VOID
+PhaseBegin (
+  IN  BOOT_PHASE  Phase
+  );
+
+VOID
+PhaseEnd (
+  IN  BOOT_PHASE  Phase
+  );
+
+UINT64
+TicksToMicroseconds (
+  IN  UINT64  Ticks
+  );
+
+VOID
+GetBootTimings (
+  OUT UINT64              *EntryTicks,
+  OUT UINT64              *CalibrationTicks,
+  OUT CONST PHASE_TIMER   **PhaseTimers
+  );
+
+VOID
+PrintBootTimings (
+  VOID
+  );
+
+
+/**
+  -----------------------------------------------------------------------------
+  Imported global variables.
+  -----------------------------------------------------------------------------
+**/
+
+extern BOOLEAN  mVerboseMode;
+extern BOOLEAN  mLogToFile;
+extern BOOLEAN  mLogToTable;
+extern BOOLEAN  mBinaryLog;
+extern BOOLEAN  mBinaryTable;
+extern UINTN    mLogLevel;
+
+
+#endif
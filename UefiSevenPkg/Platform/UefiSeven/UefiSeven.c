@@ -17,7 +17,11 @@
 #include "Display.h"
 #include "Util.h"
 #include "Filesystem.h"
+#include "BootCache.h"
 #include "Int10hHandler.h"
+#include "Log.h"
+#include "Mtrr.h"
+#include "Timing.h"
 #include "Version.h"
 
 
@@ -34,85 +38,68 @@ EFI_LOADED_IMAGE_PROTOCOL   *mUefiSevenImageInfo  = NULL;
 BOOLEAN                     mVerboseMode          = FALSE;
 BOOLEAN                     mSkipErrors           = FALSE;
 BOOLEAN                     mForceFakeVesa        = FALSE;
+BOOLEAN                     mFbWriteCombine       = FALSE;
+BOOLEAN                     mNativeResolution     = FALSE;
+UINT16                      mHandlerSerialPort    = 0;      // 0 = no handler serial output
+UINT32                      mHandlerSerialBaud    = 0;      // 0 = HANDLER_SERIAL_BAUD
+BOOLEAN                     mHandlerTrace         = FALSE;
 BOOLEAN                     mLogToFile            = FALSE;
+BOOLEAN                     mLogToTable           = FALSE;
+BOOLEAN                     mBinaryLog            = FALSE;
+BOOLEAN                     mBinaryTable          = FALSE;
+UINTN                       mLogLevel             = UEFISEVEN_LOG_LEVEL;
 CHAR16                      *mEfiFilePath         = NULL;
 EFI_FILE_HANDLE             mVolumeRoot           = NULL;
 EFI_FILE_HANDLE             mLogFileHandle        = NULL;
 
+// Reused by every PrintDebug/PrintError, so logging never allocates.
+STATIC CHAR8                mMessageBuffer[DEBUG_MESSAGE_LENGTH];
+STATIC CHAR16               mConsoleBuffer[DEBUG_MESSAGE_LENGTH];
+
+// Memory lock protocols, located once by LocateMemoryLockProtocols.
+STATIC BOOLEAN                        mLockProtocolsLocated   = FALSE;
+STATIC EFI_LEGACY_REGION_PROTOCOL     *mLegacyRegion          = NULL;
+STATIC EFI_LEGACY_REGION2_PROTOCOL    *mLegacyRegion2         = NULL;
+STATIC EFI_MEMORY_ATTRIBUTE_PROTOCOL  *mMemoryAttribute       = NULL;
+STATIC EFI_CPU_ARCH_PROTOCOL          *mCpuArch               = NULL;
+
+// Outcome of the memory lock probe, shared by unlock and lock.
+STATIC MEMORY_LOCK_STRATEGY           mLockStrategy           = { LockMethodNone, 0, 0 };
+
+// Range made read-only through page tables, writes there would fault.
+STATIC EFI_PHYSICAL_ADDRESS           mReadOnlyPagesBase      = 0;
+STATIC UINT64                         mReadOnlyPagesLength    = 0;
+
+// Block below 640 KiB for the writable shim header fields, 0 if they
+// stay within the shim itself.
+STATIC EFI_PHYSICAL_ADDRESS           mShimDataAddress        = 0;
+STATIC BOOLEAN                        mShimDataAllocated      = FALSE;
+
 
 /**
-  Fills in VESA-compatible information about supported video modes
-  in the space left for this purpose at the beginning of the
-  generated VGA ROM assembly code.
-  (See VESA BIOS EXTENSION Core Functions Standard v3.0, p26+.)
+  Fills in information about one video mode. The mode is shown
+  centered within the current GOP mode, so it must not be larger.
+  (See VESA BIOS EXTENSION Core Functions Standard v3.0, p30+.)
 
-  @param[in] StartAddress Where to begin writing VESA information.
-  @param[in] EndAddress   Pointer to the next byte after the end
-                          of all video mode information data.
+  @param[out] VbeModeInfo Mode information to be filled in.
+  @param[in] Width        Horizontal resolution of the mode.
+  @param[in] Height       Vertical resolution of the mode.
 
   @retval EFI_SUCCESS     The operation was successful
   @return other           The operation failed.
 
 **/
 EFI_STATUS
-ShimVesaInformation (
-  IN  EFI_PHYSICAL_ADDRESS  StartAddress,
-  OUT EFI_PHYSICAL_ADDRESS  *EndAddress
+FillVbeModeInfo (
+  OUT VBE_MODE_INFO         *VbeModeInfo,
+  IN  UINT32                Width,
+  IN  UINT32                Height
   )
 {
-  VBE_INFO              *VbeInfoFull;
-  VBE_INFO_BASE         *VbeInfo;
-  VBE_MODE_INFO         *VbeModeInfo;
-  UINT8                 *BufferPtr;
   UINT32                HorizontalOffsetPx;
   UINT32                VerticalOffsetPx;
   EFI_PHYSICAL_ADDRESS  FrameBufferBaseWithOffset;
 
-  if ((StartAddress == 0) || (EndAddress == NULL)) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  //
-  // Get basic video hardware information first.
-  //
-  if (EFI_ERROR (EnsureDisplayAvailable ())) {
-    PrintError (L"No display adapters were found, unable to fill in VESA information\n");
-    return EFI_NOT_FOUND;
-  }
-
-  //
-  // VESA general information.
-  //
-  VbeInfoFull = (VBE_INFO *)(UINTN)StartAddress;
-  VbeInfo   = &VbeInfoFull->Base;
-  BufferPtr = VbeInfoFull->Buffer;
-  CopyMem (VbeInfo->Signature, "VESA", 4);
-  VbeInfo->VesaVersion                  = 0x0300;
-  VbeInfo->OemNameAddress               = (UINT32)StartAddress << 12 | (UINT16)(UINTN)BufferPtr;
-  CopyMem (BufferPtr, VENDOR_NAME, sizeof (VENDOR_NAME));
-  BufferPtr += sizeof (VENDOR_NAME);
-  VbeInfo->Capabilities                 = BIT0;     // DAC width supports 8-bit color mode
-  VbeInfo->ModeListAddress              = (UINT32)StartAddress << 12 | (UINT16)(UINTN)BufferPtr;
-  *(UINT16 *)BufferPtr = 0x00F1;   // mode number
-  BufferPtr += 2;
-  *(UINT16 *)BufferPtr = 0xFFFF;   // mode list terminator
-  BufferPtr += 2;
-  VbeInfo->VideoMem64K                  = (UINT16)((mDisplayInfo.FrameBufferSize + 65535) / 65536);
-  VbeInfo->OemSoftwareVersion           = 0x0000;
-  VbeInfo->VendorNameAddress            = (UINT32)StartAddress << 12 | (UINT16)(UINTN)BufferPtr;
-  CopyMem (BufferPtr, VENDOR_NAME, sizeof (VENDOR_NAME));
-  BufferPtr += sizeof (VENDOR_NAME);
-  VbeInfo->ProductNameAddress           = (UINT32)StartAddress << 12 | (UINT16)(UINTN)BufferPtr;
-  CopyMem (BufferPtr, PRODUCT_NAME, sizeof (PRODUCT_NAME));
-  BufferPtr += sizeof (PRODUCT_NAME);
-  VbeInfo->ProductRevAddress            = (UINT32)StartAddress << 12 | (UINT16)(UINTN)BufferPtr;
-  CopyMem (BufferPtr, PRODUCT_REVISION, sizeof (PRODUCT_REVISION));
-  BufferPtr += sizeof (PRODUCT_REVISION);
-
-  //
-  // Basic VESA mode information.
-  //
-  VbeModeInfo = (VBE_MODE_INFO *)(VbeInfoFull + 1); // jump ahead by sizeof (VBE_INFO) ie. 256 bytes
   // bit0: mode supported by present hardware configuration
   // bit1: must be set for VBE v1.2+
   // bit3: color mode
@@ -125,16 +112,16 @@ ShimVesaInformation (
   //
   // Resolution.
   //
-  VbeModeInfo->Width                    = 1024;   // as expected by Windows installer
-  VbeModeInfo->Height                   = 768;    // as expected by Windows installer
+  VbeModeInfo->Width                    = (UINT16)Width;
+  VbeModeInfo->Height                   = (UINT16)Height;
   VbeModeInfo->CharCellWidth            = 8;      // used to calculate resolution in text modes
   VbeModeInfo->CharCellHeight           = 16;     // used to calculate resolution in text modes
 
   //
   // Center visible image on screen using framebuffer offset.
   //
-  HorizontalOffsetPx        = (mDisplayInfo.HorizontalResolution - 1024) / 2;
-  VerticalOffsetPx          = (mDisplayInfo.VerticalResolution - 768) / 2 * mDisplayInfo.PixelsPerScanLine;
+  HorizontalOffsetPx        = (mDisplayInfo.HorizontalResolution - Width) / 2;
+  VerticalOffsetPx          = (mDisplayInfo.VerticalResolution - Height) / 2 * mDisplayInfo.PixelsPerScanLine;
   FrameBufferBaseWithOffset = mDisplayInfo.FrameBufferBase
                                 + VerticalOffsetPx * 4      // 4 bytes per pixel
                                 + HorizontalOffsetPx * 4;   // 4 bytes per pixel
@@ -191,17 +178,615 @@ ShimVesaInformation (
   VbeModeInfo->MaxPixelClockHz          = 0;      // maximum available refresh rate
   VbeModeInfo->Vbe3                     = 0x01;   // reserved, always set to 1
 
-  *EndAddress = (UINTN)(VbeModeInfo + 1);         // jump ahead by sizeof (VBE_MODE_INFO) ie. 256 bytes
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Adds a resolution to the list of modes offered by the shim,
+  unless it is already there or the list is full.
+
+  @param[in,out] Widths   Horizontal resolution of every mode.
+  @param[in,out] Heights  Vertical resolution of every mode.
+  @param[in] Count        Number of modes in the list so far.
+  @param[in] Width        Horizontal resolution to be added.
+  @param[in] Height       Vertical resolution to be added.
+
+  @retval UINTN           Number of modes in the list now.
+
+**/
+UINTN
+AddShimMode (
+  IN OUT  UINT32    *Widths,
+  IN OUT  UINT32    *Heights,
+  IN      UINTN     Count,
+  IN      UINT32    Width,
+  IN      UINT32    Height
+  )
+{
+  UINTN   Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    if ((Widths[Index] == Width) && (Heights[Index] == Height)) {
+      return Count;
+    }
+  }
+
+  if (Count < SHIM_MAX_MODES) {
+    Widths[Count]   = Width;
+    Heights[Count]  = Height;
+    Count++;
+  }
+
+  return Count;
+}
+
+
+/**
+  Collects the resolutions the shim offers, in VBE mode number
+  order: 1024x768 first as expected by the Windows installer, then
+  the current GOP resolution, then every other GOP mode that fits
+  within the current one.
+
+  @param[out] Widths      Horizontal resolution of every mode.
+  @param[out] Heights     Vertical resolution of every mode.
+
+  @retval UINTN           Number of modes, at most SHIM_MAX_MODES.
+
+**/
+UINTN
+CollectShimModes (
+  OUT UINT32                *Widths,
+  OUT UINT32                *Heights
+  )
+{
+  CONST DISPLAY_MODE    *Mode;
+  UINTN                 Count;
+  UINT32                i;
+
+  Count = AddShimMode (Widths, Heights, 0, 1024, 768);
+  Count = AddShimMode (Widths, Heights, Count, mDisplayInfo.HorizontalResolution, mDisplayInfo.VerticalResolution);
+
+  for (i = 0; i < mDisplayInfo.ModeCount; i++) {
+    Mode = &mDisplayInfo.Modes[i];
+    if (Mode->Valid
+      && (Mode->HorizontalResolution <= mDisplayInfo.HorizontalResolution)
+      && (Mode->VerticalResolution <= mDisplayInfo.VerticalResolution)
+      )
+    {
+      Count = AddShimMode (Widths, Heights, Count, Mode->HorizontalResolution, Mode->VerticalResolution);
+    }
+  }
+
+  return Count;
+}
+
+
+/**
+  Returns the Int10h handler build selected with the handler
+  config key, the instrumented one when tracing.
+
+  @param[out] Size        Size of the handler in bytes.
+
+  @retval CONST UINT8 *   INT10H_HANDLER or INT10H_HANDLER_TRACE.
+
+**/
+CONST UINT8 *
+SelectedInt10hHandler (
+  OUT UINTN   *Size
+  )
+{
+  if (mHandlerTrace) {
+    *Size = sizeof (INT10H_HANDLER_TRACE);
+    return INT10H_HANDLER_TRACE;
+  }
+
+  *Size = sizeof (INT10H_HANDLER);
+  return INT10H_HANDLER;
+}
+
+
+/**
+  Programs the 16550 compatible UART the instrumented Int10h
+  handler prints to: 8 data bits, no parity, one stop bit, FIFOs on.
+  Done once by UefiMain so that the handler can skip it on every call.
+
+  @param[in] Port         I/O base address of the UART.
+  @param[in] Divisor      Baud rate divisor, UART_BASE_BAUD / baud rate.
+
+**/
+VOID
+InitializeHandlerSerial (
+  IN  UINT16  Port,
+  IN  UINT16  Divisor
+  )
+{
+  IoWrite8 (Port + 1, 0x00);                   // disable all interrupts
+  IoWrite8 (Port + 3, BIT7);                   // enable DLAB
+  IoWrite8 (Port + 0, (UINT8)Divisor);
+  IoWrite8 (Port + 1, (UINT8)(Divisor >> 8));
+  IoWrite8 (Port + 3, 0x03);                   // 8N1, DLAB off
+  IoWrite8 (Port + 2, 0xC7);                   // enable and clear FIFOs, 14-byte threshold
+  IoWrite8 (Port + 4, 0x0B);                   // DTR, RTS and OUT2 set
+}
+
+
+/**
+  Fills in VESA-compatible information about supported video modes
+  in the space left for this purpose at the beginning of the
+  generated VGA ROM assembly code, and the mode table right after
+  the code. All modes share the current GOP framebuffer.
+  (See VESA BIOS EXTENSION Core Functions Standard v3.0, p26+.)
+
+  @param[in] Image        Shim image being built, VESA information
+                          is written at its beginning.
+  @param[in] RomAddress   Where the image will end up, used for
+                          the real mode pointers within it.
+  @param[out] ImageSize   Number of bytes used by the shim image,
+                          including the mode table.
+
+  @retval EFI_SUCCESS     The operation was successful
+  @return other           The operation failed.
+
+**/
+EFI_STATUS
+ShimVesaInformation (
+  IN  UINT8                 *Image,
+  IN  EFI_PHYSICAL_ADDRESS  RomAddress,
+  OUT UINTN                 *ImageSize
+  )
+{
+  EFI_STATUS            Status;
+  VBE_INFO              *VbeInfoFull;
+  VBE_INFO_BASE         *VbeInfo;
+  VBE_MODE_INFO         *VbeModeInfo;
+  SHIM_HEADER           *Header;
+  UINT8                 *BufferPtr;
+  UINT32                Widths[SHIM_MAX_MODES];
+  UINT32                Heights[SHIM_MAX_MODES];
+  UINTN                 ModeCount;
+  UINTN                 ModeTableOffset;
+  UINTN                 EdidOffset;
+  UINTN                 EdidBlocks;
+  UINTN                 TraceOffset;
+  UINTN                 TraceEntries;
+  UINT16                SerialDivisor;
+  UINTN                 HandlerSize;
+  UINTN                 Index;
+
+  if ((Image == NULL) || (RomAddress == 0) || (ImageSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Get basic video hardware information first.
+  //
+  if (EFI_ERROR (EnsureDisplayAvailable ())) {
+    PrintError (L"No display adapters were found, unable to fill in VESA information\n");
+    return EFI_NOT_FOUND;
+  }
+
+  ModeCount       = CollectShimModes (Widths, Heights);
+  SelectedInt10hHandler (&HandlerSize);
+  ModeTableOffset = ALIGN_VALUE (HandlerSize, 16);
+  if (ModeTableOffset + ModeCount * sizeof (VBE_MODE_INFO) + SHIM_EDID_BLOCKS * EDID_BLOCK_SIZE > VGA_ROM_SIZE) {
+    PrintError (L"Shim size bigger than allowed (%u modes), aborting\n", ModeCount);
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  //
+  // VESA general information.
+  //
+  VbeInfoFull = (VBE_INFO *)Image;
+  VbeInfo   = &VbeInfoFull->Base;
+  BufferPtr = VbeInfoFull->Buffer;
+  CopyMem (VbeInfo->Signature, "VESA", 4);
+  VbeInfo->VesaVersion                  = 0x0300;
+  VbeInfo->OemNameAddress               = (UINT32)RomAddress << 12 | (UINT16)(BufferPtr - Image);
+  CopyMem (BufferPtr, VENDOR_NAME, sizeof (VENDOR_NAME));
+  BufferPtr += sizeof (VENDOR_NAME);
+  VbeInfo->Capabilities                 = BIT0;     // DAC width supports 8-bit color mode
+  VbeInfo->ModeListAddress              = (UINT32)RomAddress << 12 | (UINT16)(BufferPtr - Image);
+  for (Index = 0; Index < ModeCount; Index++) {
+    *(UINT16 *)BufferPtr = (UINT16)(SHIM_FIRST_MODE + Index);   // mode number
+    BufferPtr += 2;
+  }
+  *(UINT16 *)BufferPtr = 0xFFFF;   // mode list terminator
+  BufferPtr += 2;
+  VbeInfo->VideoMem64K                  = (UINT16)((mDisplayInfo.FrameBufferSize + 65535) / 65536);
+  VbeInfo->OemSoftwareVersion           = 0x0000;
+  VbeInfo->VendorNameAddress            = (UINT32)RomAddress << 12 | (UINT16)(BufferPtr - Image);
+  CopyMem (BufferPtr, VENDOR_NAME, sizeof (VENDOR_NAME));
+  BufferPtr += sizeof (VENDOR_NAME);
+  VbeInfo->ProductNameAddress           = (UINT32)RomAddress << 12 | (UINT16)(BufferPtr - Image);
+  CopyMem (BufferPtr, PRODUCT_NAME, sizeof (PRODUCT_NAME));
+  BufferPtr += sizeof (PRODUCT_NAME);
+  VbeInfo->ProductRevAddress            = (UINT32)RomAddress << 12 | (UINT16)(BufferPtr - Image);
+  CopyMem (BufferPtr, PRODUCT_REVISION, sizeof (PRODUCT_REVISION));
+  BufferPtr += sizeof (PRODUCT_REVISION);
+
+  //
+  // VESA mode information, one block per mode after the handler code.
+  //
+  VbeModeInfo = (VBE_MODE_INFO *)(Image + ModeTableOffset);
+  for (Index = 0; Index < ModeCount; Index++) {
+    Status = FillVbeModeInfo (&VbeModeInfo[Index], Widths[Index], Heights[Index]);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    PrintDebug (L"VESA mode %x: %ux%u\n", SHIM_FIRST_MODE + Index, Widths[Index], Heights[Index]);
+  }
+
+  //
+  // EDID of the display after the mode table, served by function 4F15h.
+  //
+  EdidOffset = ModeTableOffset + ModeCount * sizeof (VBE_MODE_INFO);
+  EdidBlocks = MIN (mDisplayInfo.EdidSize / EDID_BLOCK_SIZE, SHIM_EDID_BLOCKS);
+  if (EdidBlocks != 0) {
+    CopyMem (Image + EdidOffset, mDisplayInfo.Edid, EdidBlocks * EDID_BLOCK_SIZE);
+    PrintDebug (L"EDID passed on to the shim (%u blocks)\n", EdidBlocks);
+  }
+
+  //
+  // Call trace ring in what is left of the shim region, for the
+  // instrumented handler only.
+  //
+  TraceOffset  = EdidOffset + EdidBlocks * EDID_BLOCK_SIZE;
+  TraceEntries = 0;
+  if (mHandlerTrace) {
+    TraceEntries = MIN (SHIM_TRACE_ENTRIES, (VGA_ROM_SIZE - TraceOffset) / sizeof (SHIM_TRACE_ENTRY));
+  }
+
+  //
+  // Serial output of the instrumented handler, if a port was configured.
+  // UefiMain programs the UART once the shim is installed.
+  //
+  SerialDivisor = (UINT16)(UART_BASE_BAUD / ((mHandlerSerialBaud != 0) ? mHandlerSerialBaud : HANDLER_SERIAL_BAUD));
+
+  //
+  // Tell the handler where to find everything.
+  //
+  Header                  = (SHIM_HEADER *)(Image + SHIM_HEADER_OFFSET);
+  Header->Signature       = SHIM_SIGNATURE;
+  Header->ModeCount       = (UINT16)ModeCount;
+  Header->ModeTableOffset = (UINT16)ModeTableOffset;
+  Header->CurrentMode     = SHIM_FIRST_MODE | BIT14;  // linear framebuffer
+  Header->EdidOffset      = (UINT16)EdidOffset;
+  Header->EdidBlocks      = (UINT16)EdidBlocks;
+  Header->DataSegment     = (UINT16)(((mShimDataAddress != 0) ? mShimDataAddress : RomAddress) >> 4);
+  Header->TraceOffset     = (UINT16)TraceOffset;
+  Header->TraceEntries    = (UINT16)TraceEntries;
+  Header->SerialPort      = mHandlerSerialPort;           // 0 = no serial output
+  Header->SerialDivisor   = SerialDivisor;
+  Header->SerialReady     = mHandlerTrace && (mHandlerSerialPort != 0);
+
+  *ImageSize = TraceOffset + TraceEntries * sizeof (SHIM_TRACE_ENTRY);
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Copies only those parts of a buffer that differ from what is
+  already at the destination. Gaps shorter than SHIM_DIFF_MERGE
+  bytes are copied along rather than splitting the range.
+
+  @param[in] Destination  Where the data has to end up.
+  @param[in] Source       The data to be copied.
+  @param[in] Length       Number of bytes in Source.
+
+  @retval UINTN           Number of bytes actually written.
+
+**/
+UINTN
+CopyChangedMem (
+  IN  UINT8         *Destination,
+  IN  CONST UINT8   *Source,
+  IN  UINTN         Length
+  )
+{
+  UINTN   Index;
+  UINTN   RangeStart;
+  UINTN   RangeEnd;
+  UINTN   Written;
+
+  Written = 0;
+  Index   = 0;
+  while (Index < Length) {
+    if (Destination[Index] == Source[Index]) {
+      Index++;
+      continue;
+    }
+
+    //
+    // Extend the range until SHIM_DIFF_MERGE bytes in a row match.
+    //
+    RangeStart  = Index;
+    RangeEnd    = Index + 1;
+    for (Index = RangeEnd; (Index < Length) && (Index - RangeEnd < SHIM_DIFF_MERGE); Index++) {
+      if (Destination[Index] != Source[Index]) {
+        RangeEnd = Index + 1;
+      }
+    }
+
+    CopyMem (Destination + RangeStart, Source + RangeStart, RangeEnd - RangeStart);
+    Written += RangeEnd - RangeStart;
+  }
+
+  return Written;
+}
+
+
+/**
+  Writes a shim image to VGA ROM memory, unlocking it before and
+  locking it again afterwards. Only bytes that differ from what
+  is currently there are written.
+
+  @param[in] Image        The shim image, VGA_ROM_SIZE bytes.
+  @param[in] KeepWritable Leave VGA ROM memory unlocked, so that the
+                          instrumented handler can record its trace.
+
+  @retval EFI_SUCCESS     The image is in place.
+  @retval other           VGA ROM memory could not be unlocked.
+
+**/
+EFI_STATUS
+WriteShimImage (
+  IN  CONST UINT8   *Image,
+  IN  BOOLEAN       KeepWritable
+  )
+{
+  EFI_STATUS              Status;
+  MEMORY_LOCK_METHOD      UnlockMethod;
+  MEMORY_LOCK_METHOD      LockMethod;
+  MTRR_MEMORY_CACHE_TYPE  RomCacheType;
+  UINTN                   Written;
+
+  //
+  // Unlock VGA ROM memory area for writing first, remembering
+  // how it is cached as unlocking may change that.
+  //
+  RomCacheType = IsMtrrSupported () ? MtrrGetRangeType (VGA_ROM_ADDRESS, VGA_ROM_SIZE) : CacheInvalid;
+  UnlockMethod = (MEMORY_LOCK_METHOD)mBootCache.UnlockMethod;
+  PhaseBegin (PhaseMemoryUnlock);
+  Status = EnsureMemoryLock (VGA_ROM_ADDRESS, (UINT32)VGA_ROM_SIZE, UNLOCK, &UnlockMethod);
+  PhaseEnd (PhaseMemoryUnlock);
+  mBootCache.UnlockMethod = (UINT8)UnlockMethod;
+  if (EFI_ERROR (Status)) {
+    PrintDebug (L"Unable to unlock VGA ROM memory at %04x\n", VGA_ROM_ADDRESS);
+    return Status;
+  }
+
+  Written = CopyChangedMem ((UINT8 *)VGA_ROM_ADDRESS, Image, VGA_ROM_SIZE);
+  PrintDebug (L"Shim written to VGA ROM memory (%u of %u bytes changed)\n", Written, VGA_ROM_SIZE);
+
+  //
+  // Lock VGA ROM memory area to prevent further writes.
+  //
+  if (KeepWritable) {
+    PrintDebug (L"VGA ROM memory left unlocked for the handler trace\n");
+  } else {
+    LockMethod = (UnlockMethod != LockMethodNone) ? UnlockMethod : (MEMORY_LOCK_METHOD)mBootCache.LockMethod;
+    PhaseBegin (PhaseMemoryLock);
+    Status = EnsureMemoryLock (VGA_ROM_ADDRESS, (UINT32)VGA_ROM_SIZE, LOCK, &LockMethod);
+    PhaseEnd (PhaseMemoryLock);
+    mBootCache.LockMethod = (UINT8)LockMethod;
+    if (EFI_ERROR (Status)) {
+      PrintDebug (L"Unable to lock VGA ROM memory at %x but this is not essential\n",
+        VGA_ROM_ADDRESS);
+    }
+  }
+
+  //
+  // Unlocking through the MTRRs leaves the area uncached, yet Windows'
+  // real mode emulator fetches every shim instruction and VBE table
+  // from here. Put back how it was cached if locking did not, unless
+  // that was write-protected and the trace needs the area writable.
+  //
+  if ((UnlockMethod == LockMethodMtrr)
+    && (RomCacheType != CacheUncacheable)
+    && (RomCacheType != CacheInvalid)
+    )
+  {
+    PhaseBegin (PhaseMemoryLock);
+    EnsureCacheableMemory (
+      VGA_ROM_ADDRESS,
+      VGA_ROM_SIZE,
+      (KeepWritable && (RomCacheType == CacheWriteProtected)) ? CacheWriteThrough : RomCacheType);
+    PhaseEnd (PhaseMemoryLock);
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Reserves a page below 640 KiB for the shim header fields the
+  handler writes to, the current mode in particular, as they
+  cannot live in a VGA ROM that gets locked. The page used by a
+  shim that is in the VGA ROM already, e.g. when UefiSeven is
+  started twice in one boot, is used again rather than another
+  one being taken from scarce conventional memory.
+
+  @retval EFI_SUCCESS     mShimDataAddress is set.
+  @retval other           No memory was available, the fields
+                          stay within the shim.
+
+**/
+EFI_STATUS
+ReserveShimData (
+  VOID
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  Address;
+  CONST SHIM_HEADER     *RomHeader;
+
+  //
+  // A page in use already can only be the previous run's, claiming
+  // it succeeds if the shim was left over from an earlier boot.
+  //
+  RomHeader = (CONST SHIM_HEADER *)(UINTN)(VGA_ROM_ADDRESS + SHIM_HEADER_OFFSET);
+  Address   = (EFI_PHYSICAL_ADDRESS)RomHeader->DataSegment << 4;
+  if ((RomHeader->Signature == SHIM_SIGNATURE)
+    && (Address != 0)
+    && (Address < LOW_MEMORY_LIMIT)
+    && ((Address & EFI_PAGE_MASK) == 0)
+    )
+  {
+    Status = gBS->AllocatePages (AllocateAddress, EfiReservedMemoryType, 1, &Address);
+    if (!EFI_ERROR (Status) || (Status == EFI_NOT_FOUND)) {
+      mShimDataAddress    = Address;
+      mShimDataAllocated  = !EFI_ERROR (Status);
+      PrintDebug (L"Shim data page at %x reused\n", Address);
+      return EFI_SUCCESS;
+    }
+  }
+
+  Address = LOW_MEMORY_LIMIT - 1;
+  Status  = gBS->AllocatePages (AllocateMaxAddress, EfiReservedMemoryType, 1, &Address);
+  if (EFI_ERROR (Status)) {
+    PrintDebug (L"Unable to allocate the shim data page below %x (error: %r)\n", LOW_MEMORY_LIMIT, Status);
+    return Status;
+  }
 
+  mShimDataAddress    = Address;
+  mShimDataAllocated  = TRUE;
+  PrintDebug (L"Shim data page at %x\n", Address);
   return EFI_SUCCESS;
 }
 
 
+/**
+  Places the shim in conventional memory below 640 KiB instead of
+  VGA ROM memory, for machines where the latter cannot be unlocked.
+  The pages are allocated as reserved memory so that they survive
+  ExitBootServices, and the shim is rebuilt for its new location.
+  A shim placed there by a previous run is rebuilt in place.
+
+  @param[in,out] Image    Buffer of VGA_ROM_SIZE bytes to build
+                          the shim image in.
+  @param[in] ImageSize    Size of the shim image, as built for
+                          VGA ROM memory.
+  @param[out] Entry       Real mode address of the shim entry point.
+
+  @retval EFI_SUCCESS     The shim is in place.
+  @retval other           No memory was available or the VESA
+                          information could not be filled in.
+
+**/
+EFI_STATUS
+PlaceShimInLowMemory (
+  IN OUT  UINT8       *Image,
+  IN      UINTN       ImageSize,
+  OUT     IVT_ENTRY   *Entry
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  Address;
+  UINTN                 Pages;
+  BOOLEAN               Allocated;
+  CONST IVT_ENTRY       *IvtEntry;
+  CONST SHIM_HEADER     *OldHeader;
+  CONST UINT8           *Handler;
+  UINTN                 HandlerSize;
+
+  Pages     = EFI_SIZE_TO_PAGES (ImageSize);
+  Allocated = FALSE;
+  Status    = EFI_NOT_FOUND;
+
+  //
+  // With force_fakevesa every run ends up here. If Int10h points at
+  // a shim in low memory already, its pages are still reserved by
+  // the previous run, reuse them if they are large enough.
+  //
+  IvtEntry  = (CONST IVT_ENTRY *)(UINTN)IVT_ADDRESS + 0x10;
+  Address   = (EFI_PHYSICAL_ADDRESS)IvtEntry->Segment << 4;
+  OldHeader = (CONST SHIM_HEADER *)(UINTN)(Address + SHIM_HEADER_OFFSET);
+  if ((Address != 0)
+    && (Address < LOW_MEMORY_LIMIT)
+    && ((Address & EFI_PAGE_MASK) == 0)
+    && (IvtEntry->Offset == SHIM_HANDLER_OFFSET)
+    && (OldHeader->Signature == SHIM_SIGNATURE)
+    && (EFI_SIZE_TO_PAGES (OldHeader->TraceOffset + OldHeader->TraceEntries * sizeof (SHIM_TRACE_ENTRY)) >= Pages)
+    )
+  {
+    Status    = gBS->AllocatePages (AllocateAddress, EfiReservedMemoryType, Pages, &Address);
+    Allocated = !EFI_ERROR (Status);
+    if (Allocated || (Status == EFI_NOT_FOUND)) {
+      PrintDebug (L"Reusing the shim left in low memory at %x\n", Address);
+      Status = EFI_SUCCESS;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    Address = LOW_MEMORY_LIMIT - 1;
+    Status  = gBS->AllocatePages (AllocateMaxAddress, EfiReservedMemoryType, Pages, &Address);
+    if (EFI_ERROR (Status)) {
+      PrintError (L"Unable to allocate %u pages below %x (error: %r)\n", Pages, LOW_MEMORY_LIMIT, Status);
+      return Status;
+    }
+    Allocated = TRUE;
+  }
+
+  Handler = SelectedInt10hHandler (&HandlerSize);
+  ZeroMem (Image, EFI_PAGES_TO_SIZE (Pages));
+  CopyMem (Image, Handler, HandlerSize);
+  PhaseBegin (PhaseShimVesaInformation);
+  Status = ShimVesaInformation (Image, Address, &ImageSize);
+  PhaseEnd (PhaseShimVesaInformation);
+  if (EFI_ERROR (Status)) {
+    if (Allocated) {
+      gBS->FreePages (Address, Pages);
+    }
+    return Status;
+  }
+
+  CopyMem ((VOID *)(UINTN)Address, Image, EFI_PAGES_TO_SIZE (Pages));
+
+  // Pages are aligned, so the shim starts at offset 0 of its segment.
+  Entry->Segment = (UINT16)((UINT32)Address >> 4);
+  Entry->Offset  = (UINT16)SHIM_HANDLER_OFFSET;
+  PrintDebug (L"Shim placed in low memory at %x, Int10h handler at %04x:%04x\n",
+    Address, Entry->Segment, Entry->Offset);
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+  Checks if an IVT entry points into a copy of one particular
+  Int10h handler build.
+
+  @param[in] Entry        The IVT entry.
+  @param[in] Handler      The handler build.
+  @param[in] HandlerSize  Size of the handler build in bytes.
+
+  @retval TRUE            The entry points at the handler.
+  @retval FALSE           The entry points somewhere else.
+
+**/
+BOOLEAN
+IsShimHandler (
+  IN  IVT_ENTRY   *Entry,
+  IN  CONST UINT8 *Handler,
+  IN  UINTN       HandlerSize
+  )
+{
+  return (Entry->Offset < HandlerSize)
+    && (CompareMem (
+          (VOID *)(UINTN)((Entry->Segment << 4) + Entry->Offset),
+          Handler + Entry->Offset,
+          HandlerSize - Entry->Offset) == 0);
+}
+
+
 /**
   Checkes if an Int10h handler is already defined in the
   Interrupt Vector Table (IVT), points to somewhere
   within VGA ROM memory and this memory is not filled
-  with protective opcodes.
+  with protective opcodes. A shim UefiSeven placed in
+  low memory before is accepted as well.
 
   @retval TRUE            An Int10h handler was found in IVT.
   @retval FALSE           An Int10h handler was not found in IVT.
@@ -237,6 +822,14 @@ IsInt10hHandlerDefined (
         Int10hEntry->Segment, Int10hEntry->Offset, Opcode);
       return TRUE;
     }
+  } else if ((Int10hHandler < LOW_MEMORY_LIMIT)
+    && (IsShimHandler (Int10hEntry, INT10H_HANDLER, sizeof (INT10H_HANDLER))
+      || IsShimHandler (Int10hEntry, INT10H_HANDLER_TRACE, sizeof (INT10H_HANDLER_TRACE)))
+    )
+  {
+    PrintDebug (L"Int10h IVT entry points at a UefiSeven shim in low memory (%04x:%04x), accepting handler\n",
+      Int10hEntry->Segment, Int10hEntry->Offset);
+    return TRUE;
   } else {
     PrintDebug (L"Int10h IVT entry points at location (%04x:%04x) outside VGA ROM memory area (%04x..%04x), rejecting handler\n",
       Int10hEntry->Segment, Int10hEntry->Offset, VGA_ROM_ADDRESS, VGA_ROM_ADDRESS+VGA_ROM_SIZE);
@@ -247,32 +840,193 @@ IsInt10hHandlerDefined (
 
 /**
   Attempts to either unlock a memory area for writing or
-  lock it to prevent writes. Makes use of a number of approaches
-  to achieve the desired result.
+  lock it to prevent writes using one particular approach.
 
+  @param[in] Method         The approach to use.
   @param[in] StartAddress   Where the desired memory area begins.
   @param[in] Length         Number of bytes from StartAddress that
                             need to be locked or unlocked.
   @param[in] Operation      Whether the area is to be locked or unlocked.
+  @param[out] Granularity   Size of the blocks the approach works on.
 
-  @retval TRUE              An Int10h handler was found in IVT.
-  @retval FALSE             An Int10h handler was not found in IVT.
+  @retval EFI_SUCCESS       The memory area is now in the desired state.
+  @retval EFI_UNSUPPORTED   The approach is not available on this system.
+  @retval other             The approach did not have the desired effect.
 
 **/
 EFI_STATUS
-EnsureMemoryLock (
+ApplyMemoryLockMethod (
+  IN  MEMORY_LOCK_METHOD      Method,
   IN  EFI_PHYSICAL_ADDRESS    StartAddress,
   IN  UINT32                  Length,
-  IN  MEMORY_LOCK_OPERATION   Operation
+  IN  MEMORY_LOCK_OPERATION   Operation,
+  OUT UINT32                  *Granularity
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_PHYSICAL_ADDRESS          PageBase;
+  UINT64                        PageLength;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR Descriptor;
+  CONST CHAR16                  *MethodStr;
+
+  // Page based methods cover exactly the pages spanned by the area.
+  PageBase    = StartAddress & ~(EFI_PHYSICAL_ADDRESS)EFI_PAGE_MASK;
+  PageLength  = EFI_PAGES_TO_SIZE (EFI_SIZE_TO_PAGES (StartAddress + Length - PageBase));
+  Status      = EFI_SUCCESS;
+
+  LocateMemoryLockProtocols ();
+
+  switch (Method) {
+    case LockMethodLegacyRegion:
+      if (mLegacyRegion == NULL) {
+        return EFI_UNSUPPORTED;
+      }
+      if (Operation == UNLOCK) {
+        /*Status =*/ mLegacyRegion->UnLock (mLegacyRegion, (UINT32)StartAddress, Length, Granularity);
+      } else {
+        /*Status =*/ mLegacyRegion->Lock (mLegacyRegion, (UINT32)StartAddress, Length, Granularity);
+      }
+      MethodStr = L"EfiLegacyRegionProtocol";
+      break;
+
+    case LockMethodLegacyRegion2:
+      if (mLegacyRegion2 == NULL) {
+        return EFI_UNSUPPORTED;
+      }
+      if (Operation == UNLOCK) {
+        /*Status =*/ mLegacyRegion2->UnLock (mLegacyRegion2, (UINT32)StartAddress, Length, Granularity);
+      } else {
+        /*Status =*/ mLegacyRegion2->Lock (mLegacyRegion2, (UINT32)StartAddress, Length, Granularity);
+      }
+      MethodStr = L"EfiLegacyRegion2Protocol";
+      break;
+
+    case LockMethodMemoryAttribute:
+      if (mMemoryAttribute == NULL) {
+        return EFI_UNSUPPORTED;
+      }
+      if (Operation == UNLOCK) {
+        Status = mMemoryAttribute->ClearMemoryAttributes (mMemoryAttribute, PageBase, PageLength, EFI_MEMORY_RO);
+      } else {
+        Status = mMemoryAttribute->SetMemoryAttributes (mMemoryAttribute, PageBase, PageLength, EFI_MEMORY_RO);
+      }
+      *Granularity = EFI_PAGE_SIZE;
+      MethodStr = L"EfiMemoryAttributeProtocol";
+      break;
+
+    case LockMethodCpuArch:
+      if (mCpuArch == NULL) {
+        return EFI_UNSUPPORTED;
+      }
+      //
+      // Goes through the GCD so its memory map stays in sync with the page
+      // tables. The cacheability bits are kept as they are, as the GCD
+      // replaces all attributes of the range.
+      //
+      Status = gDS->GetMemorySpaceDescriptor (PageBase, &Descriptor);
+      if (!EFI_ERROR (Status)) {
+        Status = gDS->SetMemorySpaceAttributes (
+                        PageBase,
+                        PageLength,
+                        (Descriptor.Attributes & ~EFI_MEMORY_RO) | ((Operation == UNLOCK) ? 0 : EFI_MEMORY_RO));
+      }
+      *Granularity = EFI_PAGE_SIZE;
+      MethodStr = L"EfiCpuArchProtocol";
+      break;
+
+    case LockMethodMtrr:
+      if (!IsMtrrSupported () || (FIXED_MTRR_SIZE < Length)) {
+        return EFI_UNSUPPORTED;
+      }
+      // Has to take effect right away, but only the boot processor writes to the ROM.
+      MtrrQueueMemoryAttribute (
+        StartAddress,
+        FIXED_MTRR_SIZE,
+        (Operation == UNLOCK) ? CacheUncacheable : CacheWriteProtected);
+      MtrrCommit (FALSE);
+      *Granularity  = FIXED_MTRR_SIZE;
+      MethodStr     = L"MTRRs";
+      break;
+
+    default:
+      return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Page table protection cannot be probed by writing, it would
+  // fault. Trust the protocol instead and remember the range.
+  //
+  if ((Method == LockMethodMemoryAttribute) || (Method == LockMethodCpuArch)) {
+    if (EFI_ERROR (Status)) {
+      Status = EFI_DEVICE_ERROR;
+    } else if (Operation == LOCK) {
+      mReadOnlyPagesBase    = PageBase;
+      mReadOnlyPagesLength  = PageLength;
+    } else if ((PageBase <= mReadOnlyPagesBase)
+      && (mReadOnlyPagesBase + mReadOnlyPagesLength <= PageBase + PageLength)
+      )
+    {
+      mReadOnlyPagesLength  = 0;
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    if (Operation == UNLOCK) {
+      Status = CanWriteAtAddress (StartAddress) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+    } else {
+      Status = CanWriteAtAddress (StartAddress) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+    }
+  }
+
+  PrintDebug (L"%s %sing memory at %x with %s (granularity %x)\n",
+    EFI_ERROR (Status) ? L"Failure" : L"Success",
+    (Operation == UNLOCK) ? L"unlock" : L"lock",
+    StartAddress,
+    MethodStr,
+    *Granularity);
+
+  return Status;
+}
+
+
+/**
+  Attempts to either unlock a memory area for writing or
+  lock it to prevent writes. The first call probes a number of
+  approaches, starting with the one that is known to have worked
+  on a previous boot. Whichever works is then used for both
+  unlocking and locking, and approaches that failed are not
+  tried again.
+
+  @param[in] StartAddress   Where the desired memory area begins.
+  @param[in] Length         Number of bytes from StartAddress that
+                            need to be locked or unlocked.
+  @param[in] Operation      Whether the area is to be locked or unlocked.
+  @param[in,out] Method     On input, the approach to try first.
+                            On output, the approach that worked.
+
+  @retval EFI_SUCCESS       The memory area is now in the desired state.
+  @retval EFI_UNSUPPORTED   None of the approaches is available on this system.
+  @retval other             None of the approaches worked.
+
+**/
+EFI_STATUS
+EnsureMemoryLock (
+  IN      EFI_PHYSICAL_ADDRESS    StartAddress,
+  IN      UINT32                  Length,
+  IN      MEMORY_LOCK_OPERATION   Operation,
+  IN OUT  MEMORY_LOCK_METHOD      *Method
   )
 {
   EFI_STATUS                    Status = EFI_NOT_READY;
+  MEMORY_LOCK_METHOD            Preferred;
+  MEMORY_LOCK_METHOD            Candidate;
+  UINTN                         Index;
   UINT32                        Granularity;
-  EFI_LEGACY_REGION_PROTOCOL    *LegacyRegion;
-  EFI_LEGACY_REGION2_PROTOCOL   *LegacyRegion2;
+  EFI_PHYSICAL_ADDRESS          EndAddress;
+  BOOLEAN                       Available;
   CONST CHAR16                  *OperationStr;
 
-  if ((StartAddress == 0) || (Length == 0)) {
+  if ((StartAddress == 0) || (Length == 0) || (Method == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
@@ -290,72 +1044,61 @@ EnsureMemoryLock (
   //
   // Check if we need to perform any operation.
   //
-  if ((Operation == UNLOCK) && CanWriteAtAddress (StartAddress)) {
-    PrintDebug (L"Memory at %x already %sed\n", StartAddress, OperationStr);
-    Status = EFI_SUCCESS;
-  } else if ((Operation == LOCK) && !CanWriteAtAddress (StartAddress)) {
+  if (((Operation == UNLOCK) && CanWriteAtAddress (StartAddress))
+    || ((Operation == LOCK) && !CanWriteAtAddress (StartAddress))
+    )
+  {
     PrintDebug (L"Memory at %x already %sed\n", StartAddress, OperationStr);
-    Status = EFI_SUCCESS;
+    *Method = LockMethodNone;
+    return EFI_SUCCESS;
   }
 
   //
-  // Try to lock/unlock with EfiLegacyRegionProtocol.
+  // Stick to the approach the probe settled on, or else try the one
+  // that worked on a previous boot, then all the others in order:
+  // EfiLegacyRegionProtocol, EfiLegacyRegion2Protocol,
+  // EfiMemoryAttributeProtocol, EfiCpuArchProtocol, MTRRs.
   //
-  if (EFI_ERROR (Status)) {
-    Status = gBS->LocateProtocol (&gEfiLegacyRegionProtocolGuid, NULL, (VOID **)&LegacyRegion);
-    if (!EFI_ERROR (Status)) {
-      if (Operation == UNLOCK) {
-        /*Status =*/ LegacyRegion->UnLock (LegacyRegion, (UINT32)StartAddress, Length, &Granularity);
-        Status = CanWriteAtAddress (StartAddress) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
-      } else {
-        /*Status =*/ LegacyRegion->Lock (LegacyRegion, (UINT32)StartAddress, Length, &Granularity);
-        Status = CanWriteAtAddress (StartAddress) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
-      }
-
-      PrintDebug (L"%s %sing memory at %x with EfiLegacyRegionProtocol\n",
-        EFI_ERROR (Status) ? L"Failure" : L"Success",
-        OperationStr,
-        StartAddress);
-    }
-  }
+  Preferred = (mLockStrategy.Method != LockMethodNone) ? mLockStrategy.Method : *Method;
+  Available = FALSE;
 
   //
-  // Try to lock/unlock with EfiLegacyRegion2Protocol.
+  // Once known, cover whole blocks of the settled approach, so that
+  // locking acts on exactly the range that unlocking did.
   //
-  if (EFI_ERROR (Status)) {
-    Status = gBS->LocateProtocol (&gEfiLegacyRegion2ProtocolGuid, NULL, (VOID **)&LegacyRegion2);
-    if (!EFI_ERROR (Status)) {
-      if (Operation == UNLOCK) {
-        /*Status =*/ LegacyRegion2->UnLock (LegacyRegion2, (UINT32)StartAddress, Length, &Granularity);
-        Status = CanWriteAtAddress (StartAddress) ? EFI_SUCCESS : EFI_DEVICE_ERROR;;
-      } else {
-        /*Status =*/ LegacyRegion2->Lock (LegacyRegion2, (UINT32)StartAddress, Length, &Granularity);
-        Status = CanWriteAtAddress (StartAddress) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
-      }
+  Granularity = mLockStrategy.Granularity;
+  if ((mLockStrategy.Method != LockMethodNone) && (Granularity != 0) && ((Granularity & (Granularity - 1)) == 0)) {
+    EndAddress    = ALIGN_VALUE (StartAddress + Length, Granularity);
+    StartAddress &= ~(EFI_PHYSICAL_ADDRESS)(Granularity - 1);
+    Length        = (UINT32)(EndAddress - StartAddress);
+  }
 
-      PrintDebug (L"%s %sing memory at %x with EfiLegacyRegion2Protocol\n",
-        EFI_ERROR (Status) ? L"Failure" : L"Success",
-        OperationStr,
-        StartAddress);
+  for (Index = LockMethodNone; Index < LockMethodMax; Index++) {
+    // The preferred approach takes the place of LockMethodNone.
+    Candidate = (Index == LockMethodNone) ? Preferred : (MEMORY_LOCK_METHOD)Index;
+    if ((Candidate <= LockMethodNone) || (Candidate >= LockMethodMax)
+      || ((Index != LockMethodNone) && (Candidate == Preferred))
+      || ((mLockStrategy.FailedMethods & (1U << Candidate)) != 0)
+      )
+    {
+      continue;
     }
-  }
 
-  //
-  // Try to lock/unlock via an MTRR.
-  //
-  if (EFI_ERROR (Status) && IsMtrrSupported () && (FIXED_MTRR_SIZE >= Length)) {
-    if (Operation == UNLOCK) {
-      MtrrSetMemoryAttribute (StartAddress, FIXED_MTRR_SIZE, CacheUncacheable);
-      Status = CanWriteAtAddress (StartAddress) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
-    } else {
-      MtrrSetMemoryAttribute (StartAddress, FIXED_MTRR_SIZE, CacheWriteProtected);
-      Status = CanWriteAtAddress (StartAddress) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+    Granularity = 0;
+    Status = ApplyMemoryLockMethod (Candidate, StartAddress, Length, Operation, &Granularity);
+    if (!EFI_ERROR (Status)) {
+      mLockStrategy.Method      = Candidate;
+      mLockStrategy.Granularity = Granularity;
+      *Method = Candidate;
+      break;
     }
 
-    PrintDebug (L"%s %sing memory at %x with MTRRs\n",
-      EFI_ERROR (Status) ? L"Failure" : L"Success",
-      OperationStr,
-      StartAddress);
+    Available = Available || (Status != EFI_UNSUPPORTED);
+    mLockStrategy.FailedMethods |= 1U << Candidate;
+    if (mLockStrategy.Method == Candidate) {
+      mLockStrategy.Method      = LockMethodNone;
+      mLockStrategy.Granularity = 0;
+    }
   }
 
   //
@@ -363,14 +1106,56 @@ EnsureMemoryLock (
   //
   if (EFI_ERROR (Status)) {
     PrintDebug (L"Unable to find a way to %s memory at %x\n", OperationStr, StartAddress);
+    if (Available && (Status == EFI_UNSUPPORTED)) {
+      Status = EFI_DEVICE_ERROR;
+    }
   }
 
   return Status;
 }
 
 
+/**
+  Looks for the protocols that memory locking relies on,
+  only the first time it is called.
+
+**/
+VOID
+LocateMemoryLockProtocols (
+  VOID
+  )
+{
+  if (mLockProtocolsLocated) {
+    return;
+  }
+  mLockProtocolsLocated = TRUE;
+
+  if (EFI_ERROR (gBS->LocateProtocol (&gEfiLegacyRegionProtocolGuid, NULL, (VOID **)&mLegacyRegion))) {
+    mLegacyRegion = NULL;
+  }
+  if (EFI_ERROR (gBS->LocateProtocol (&gEfiLegacyRegion2ProtocolGuid, NULL, (VOID **)&mLegacyRegion2))) {
+    mLegacyRegion2 = NULL;
+  }
+
+  if (EFI_ERROR (gBS->LocateProtocol (&gEfiMemoryAttributeProtocolGuid, NULL, (VOID **)&mMemoryAttribute))) {
+    mMemoryAttribute = NULL;
+  }
+  if (EFI_ERROR (gBS->LocateProtocol (&gEfiCpuArchProtocolGuid, NULL, (VOID **)&mCpuArch))) {
+    mCpuArch = NULL;
+  }
+
+  PrintDebug (L"Memory lock protocols: LegacyRegion %d, LegacyRegion2 %d, MemoryAttribute %d, CpuArch %d\n",
+    mLegacyRegion != NULL,
+    mLegacyRegion2 != NULL,
+    mMemoryAttribute != NULL,
+    mCpuArch != NULL);
+}
+
+
 /**
   Checks if writes are possible in a particular memory area.
+  Pages known or reported to be read-only are not probed, as
+  the write would cause a page fault.
 
   @param[in] Address      The memory location to be checked.
 
@@ -385,9 +1170,38 @@ CanWriteAtAddress (
   IN  EFI_PHYSICAL_ADDRESS  Address
   )
 {
-  BOOLEAN   CanWrite;
-  UINT8     *TestPtr;
-  UINT8     OldValue;
+  BOOLEAN                         CanWrite;
+  UINT8                           *TestPtr;
+  UINT8                           OldValue;
+  UINT64                          Attributes;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR Descriptor;
+
+  if ((Address >= mReadOnlyPagesBase) && (Address - mReadOnlyPagesBase < mReadOnlyPagesLength)) {
+    return FALSE;
+  }
+
+  //
+  // Without EfiMemoryAttributeProtocol the GCD memory map is the
+  // best record of page table protection there is.
+  //
+  LocateMemoryLockProtocols ();
+  if (mMemoryAttribute != NULL) {
+    if (!EFI_ERROR (mMemoryAttribute->GetMemoryAttributes (
+                                        mMemoryAttribute,
+                                        Address & ~(EFI_PHYSICAL_ADDRESS)EFI_PAGE_MASK,
+                                        EFI_PAGE_SIZE,
+                                        &Attributes))
+      && ((Attributes & EFI_MEMORY_RO) != 0)
+      )
+    {
+      return FALSE;
+    }
+  } else if (!EFI_ERROR (gDS->GetMemorySpaceDescriptor (Address, &Descriptor))
+    && ((Descriptor.Attributes & EFI_MEMORY_RO) != 0)
+    )
+  {
+    return FALSE;
+  }
 
   TestPtr = (UINT8 *)(Address);
   OldValue = *TestPtr;
@@ -476,28 +1290,47 @@ PrintFuncNameMessage (
   )
 {
   VA_LIST   Marker;
-  CHAR16    *Buffer;
-  UINTN     BufferSize;
-  CHAR8     *AsciiBuffer;
-  UINTN     AsciiBufferSize;
+  UINTN     PrefixLength;
+  UINTN     Length;
+  UINTN     Index;
+  BOOLEAN   LogText;
+
+  if ((FuncName == NULL) || (FormatString == NULL) || !(IsError || mVerboseMode || mLogToFile || mLogToTable)) {
+    return;
+  }
 
-  if ((FuncName == NULL) || (FormatString == NULL) || !(IsError || mVerboseMode || mLogToFile)) {
+  if ((IsError ? LOG_LEVEL_ERROR : LOG_LEVEL_DEBUG) > mLogLevel) {
     return;
   }
 
   //
-  // Generate the main message.
+  // Binary log records need no formatting at all. The log file
+  // and the log table each have a format of their own.
   //
-  BufferSize = DEBUG_MESSAGE_LENGTH * sizeof (CHAR16);
-  Buffer = (CHAR16 *)AllocatePool (BufferSize);
-  if (Buffer == NULL) {
-    return;
+  LogText = (mLogToFile && !mBinaryLog) || (mLogToTable && !mBinaryTable);
+  if ((mLogToFile && mBinaryLog) || (mLogToTable && mBinaryTable)) {
+    VA_START (Marker, FormatString);
+    LogAppendBinary (IsError, FuncName, FormatString, Marker);
+    VA_END (Marker);
+
+    if (!(IsError || mVerboseMode || LogText)) {
+      return;
+    }
   }
+
+  //
+  // Generate the "FuncName: message" log line straight in ASCII.
+  //
+  PrefixLength = AsciiSPrint (mMessageBuffer, sizeof (mMessageBuffer), "%a: ", FuncName);
   VA_START (Marker, FormatString);
-  UnicodeVSPrint (Buffer, BufferSize, FormatString, Marker);
+  Length = PrefixLength + AsciiVSPrintUnicodeFormat (
+                            mMessageBuffer + PrefixLength,
+                            sizeof (mMessageBuffer) - PrefixLength,
+                            FormatString,
+                            Marker);
   VA_END (Marker);
 
-  if (IsError || mVerboseMode) {
+  if ((IsError || mVerboseMode) && (gST != NULL) && (gST->ConOut != NULL)) {
     //
     // Switch to text mode if needed.
     //
@@ -507,11 +1340,14 @@ PrintFuncNameMessage (
     // Output using apropriate colors.
     //
     gST->ConOut->SetAttribute (gST->ConOut, EFI_DARKGRAY);
-    AsciiPrint ("%.10a ", FuncName);
+    UnicodeSPrint (mConsoleBuffer, sizeof (mConsoleBuffer), L"%.10a ", FuncName);
+    gST->ConOut->OutputString (gST->ConOut, mConsoleBuffer);
+
     gST->ConOut->SetAttribute (gST->ConOut, IsError ? EFI_YELLOW : EFI_LIGHTGRAY);
-    if ((gST != NULL) && (gST->ConOut != NULL)) {
-      gST->ConOut->OutputString (gST->ConOut, Buffer);
+    for (Index = PrefixLength; Index <= Length; Index++) {
+      mConsoleBuffer[Index - PrefixLength] = (CHAR16)mMessageBuffer[Index];
     }
+    gST->ConOut->OutputString (gST->ConOut, mConsoleBuffer);
 
     //
     // Cleanup.
@@ -519,22 +1355,9 @@ PrintFuncNameMessage (
     gST->ConOut->SetAttribute (gST->ConOut, EFI_LIGHTGRAY);
   }
 
-  if (mLogToFile) {
-    if (mLogFileHandle != NULL) {
-      AsciiBufferSize = AsciiStrLen (FuncName) + 2 + StrLen (Buffer) + 1;
-      AsciiBuffer = AllocatePool (AsciiBufferSize);
-      if (AsciiBuffer != NULL) {
-        AsciiSPrint (AsciiBuffer, AsciiBufferSize, "%a: %s", FuncName, Buffer);
-        AsciiBufferSize = AsciiStrLen (AsciiBuffer);
-        mLogFileHandle->SetPosition (mLogFileHandle, (UINT64)-1);
-        mLogFileHandle->Write (mLogFileHandle, &AsciiBufferSize, AsciiBuffer);
-        mLogFileHandle->Flush (mLogFileHandle);
-        FreePool (AsciiBuffer);
-      }
-    }
+  if (LogText) {
+    LogAppend (mMessageBuffer, Length);
   }
-
-  FreePool (Buffer);
 }
 
 
@@ -550,11 +1373,16 @@ WaitForEnter (
     PrintDebug (L"Press Enter to continue\n");
   }
 
+  // The machine may well be reset from here, keep what was logged so far.
+  LogFlush ();
+
+  PhaseBegin (PhaseWaitForUser);
   gST->ConIn->Reset (gST->ConIn, FALSE);
   do {
     gBS->WaitForEvent (1, &gST->ConIn->WaitForKey, &EventIndex);
     gST->ConIn->ReadKeyStroke (gST->ConIn, &Key);
   } while (Key.UnicodeChar != CHAR_CARRIAGE_RETURN);
+  PhaseEnd (PhaseWaitForUser);
 }
 
 
@@ -570,44 +1398,50 @@ WaitForEnterAndStall (
 
 BOOLEAN
 ReadConfig (
-  VOID
+  IN  CHAR16  *FilePath
   )
 {
   EFI_STATUS  Status;
-  CHAR16      *FilePath = NULL;
   UINT8       *FileContents;
   UINTN       FileBytes;
   VOID        *Context;
   UINTN       Num;
+  CHAR8       *Str;
 
-  if (mEfiFilePath == NULL) {
+  if ((FilePath == NULL) || !FileExists (mVolumeRoot, FilePath)) {
     return FALSE;
   }
 
   //
-  // Preferred UefiSeven.ini, instead of bootx64.ini / bootmgfw.ini.
-  //
-  // Check if <MyName>.ini exists
-  //Status = ChangeExtension (mEfiFilePath, L"ini", (VOID **)&FilePath);
-  // Check if UefiSeven.ini exists
-  Status = GetFilenameInSameDirectory (mEfiFilePath, L"UefiSeven.ini", (VOID **)&FilePath);
-
-  if (EFI_ERROR (Status) || (FilePath == NULL) || !FileExists (mVolumeRoot, FilePath)) {
-    if (FilePath != NULL) {
-      FreePool (FilePath);
-    }
-    return FALSE;
+  // The config file has not changed since the previous boot,
+  // reuse what was parsed back then.
+  //
+  if (mBootCacheLoaded && mBootCache.ConfigValid) {
+    mSkipErrors     = mBootCache.SkipErrors;
+    mForceFakeVesa  = mBootCache.ForceFakeVesa;
+    mFbWriteCombine = mBootCache.FbWriteCombine;
+    mNativeResolution = mBootCache.NativeRes;
+    mHandlerSerialPort = mBootCache.HandlerPort;
+    mHandlerSerialBaud = mBootCache.HandlerBaud;
+    mHandlerTrace   = mBootCache.HandlerTrace;
+    mVerboseMode    = mBootCache.VerboseMode;
+    mLogToFile      = mBootCache.LogToFile;
+    mLogToTable     = mBootCache.LogToTable;
+    mBinaryLog      = mBootCache.BinaryLog;
+    mBinaryTable    = mBootCache.BinaryTable;
+    mLogLevel       = MIN (mBootCache.LogLevel, UEFISEVEN_LOG_LEVEL);
+    return TRUE;
   }
 
   // Read file contents.
   Status = FileRead (mVolumeRoot, FilePath, (VOID **)&FileContents, &FileBytes);
-  FreePool (FilePath);
   if (EFI_ERROR (Status)) {
     return FALSE;
   }
 
   Context = OpenIniFile (FileContents, FileBytes);
   if (Context == NULL) {
+    FreePool (FileContents);
     return FALSE;
   }
 
@@ -623,6 +1457,32 @@ ReadConfig (
   Status          = GetDecimalUintnFromDataFile (Context, "config", "force_fakevesa", &Num);
   mForceFakeVesa  = (!EFI_ERROR (Status) && (Num == 1));
 
+  //
+  // Check if the framebuffer should be mapped write-combining
+  //
+  Status          = GetDecimalUintnFromDataFile (Context, "config", "fb_writecombine", &Num);
+  mFbWriteCombine = (!EFI_ERROR (Status) && (Num == 1));
+
+  //
+  // Check if the display should be left at its native resolution
+  //
+  Status            = GetDecimalUintnFromDataFile (Context, "config", "native_resolution", &Num);
+  mNativeResolution = (!EFI_ERROR (Status) && (Num == 1));
+
+  //
+  // Check if the instrumented Int10h handler should be used
+  //
+  Status          = GetStringFromDataFile (Context, "config", "handler", &Str);
+  mHandlerTrace   = (!EFI_ERROR (Status) && (AsciiStriCmp (Str, "trace") == 0));
+
+  //
+  // Check which serial port the instrumented Int10h handler prints to
+  //
+  Status             = GetHexUintnFromDataFile (Context, "config", "handler_port", &Num);
+  mHandlerSerialPort = (!EFI_ERROR (Status) && (Num <= 0xFFFF)) ? (UINT16)Num : 0;
+  Status             = GetDecimalUintnFromDataFile (Context, "config", "handler_baud", &Num);
+  mHandlerSerialBaud = (!EFI_ERROR (Status) && (Num > 0) && (Num <= UART_BASE_BAUD)) ? (UINT32)Num : 0;
+
   //
   // Check if we should run in verbose mode
   //
@@ -633,12 +1493,43 @@ ReadConfig (
   // Check if we should log to file
   //
   Status          = GetDecimalUintnFromDataFile (Context, "config", "logfile", &Num);
-  mLogToFile      = (!EFI_ERROR (Status) && (Num == 1));
+  mLogToFile      = (!EFI_ERROR (Status) && ((Num == 1) || (Num == 2)));
+  mBinaryLog      = (!EFI_ERROR (Status) && (Num == 2));
+
+  //
+  // Check if we should publish the log in memory for later stages
+  //
+  Status          = GetDecimalUintnFromDataFile (Context, "config", "logtable", &Num);
+  mLogToTable     = (!EFI_ERROR (Status) && ((Num == 1) || (Num == 2)));
+  mBinaryTable    = (!EFI_ERROR (Status) && (Num == 2));
+
+  //
+  // Check if messages should be filtered further than the build does
+  //
+  Status          = GetDecimalUintnFromDataFile (Context, "config", "loglevel", &Num);
+  if (!EFI_ERROR (Status)) {
+    mLogLevel     = MIN (Num, UEFISEVEN_LOG_LEVEL);
+  }
 
   CloseIniFile (Context);
 
   FreePool (FileContents);
 
+  mBootCache.ConfigValid    = TRUE;
+  mBootCache.SkipErrors     = mSkipErrors;
+  mBootCache.ForceFakeVesa  = mForceFakeVesa;
+  mBootCache.FbWriteCombine = mFbWriteCombine;
+  mBootCache.NativeRes      = mNativeResolution;
+  mBootCache.HandlerPort    = mHandlerSerialPort;
+  mBootCache.HandlerBaud    = mHandlerSerialBaud;
+  mBootCache.HandlerTrace   = mHandlerTrace;
+  mBootCache.VerboseMode    = mVerboseMode;
+  mBootCache.LogToFile      = mLogToFile;
+  mBootCache.LogToTable     = mLogToTable;
+  mBootCache.BinaryLog      = mBinaryLog;
+  mBootCache.BinaryTable    = mBinaryTable;
+  mBootCache.LogLevel       = (UINT8)mLogLevel;
+
   return TRUE;
 }
 
@@ -661,25 +1552,35 @@ UefiMain (
   IN EFI_SYSTEM_TABLE   *SystemTable
   )
 {
-  EFI_PHYSICAL_ADDRESS    Int10hHandlerAddress;
+  UINT8                   *ShimImage = NULL;
+  UINTN                   ShimImageSize;
+  SHIM_HEADER             *Header;
+  CONST UINT8             *Handler;
+  UINTN                   HandlerSize;
   IVT_ENTRY               *IvtInt10hHandlerEntry;
   IVT_ENTRY               NewInt10hHandlerEntry;
   EFI_PHYSICAL_ADDRESS    IvtAddress;
   EFI_STATUS              Status;
+  EFI_STATUS              InstallStatus = EFI_ABORTED;
   EFI_STATUS              IvtAllocationStatus;
   EFI_STATUS              IvtFreeStatus;
   EFI_INPUT_KEY           Key;
   CHAR16                  *LaunchPath = NULL;
+  CHAR16                  *ConfigFilePath = NULL;
   CHAR16                  *LogFilePath = NULL;
   CHAR16                  *VerboseFilePath = NULL;
   CHAR16                  *SkipFilePath = NULL;
   CHAR16                  *FFVFilePath = NULL;
   EFI_FILE_IO_INTERFACE   *Volume;
-  EFI_FILE_INFO           *FileInfo;
+  UINT32                  NativeWidth;
+  UINT32                  NativeHeight;
+
+  TimingInitialize ();
 
   //
   // Try freeing IVT memory area in case it has already been allocated.
   //
+  PhaseBegin (PhaseIvtClaim);
   IvtFreeStatus = gBS->FreePages (IVT_ADDRESS, 1);
 
   //
@@ -689,6 +1590,7 @@ UefiMain (
   //
   IvtAddress = IVT_ADDRESS;
   IvtAllocationStatus = gBS->AllocatePages (AllocateAddress, EfiBootServicesCode, 1, &IvtAddress);
+  PhaseEnd (PhaseIvtClaim);
 
   PrintDebug (L"Force free IVT area result: %r\n", IvtFreeStatus);
 
@@ -703,6 +1605,7 @@ UefiMain (
   }
 
   // Open volume where UefiSeven resides.
+  PhaseBegin (PhaseVolumeOpen);
   Status = gBS->HandleProtocol (mUefiSevenImageInfo->DeviceHandle, &gEfiSimpleFileSystemProtocolGuid, (VOID **)&Volume);
   if (EFI_ERROR (Status)) {
     PrintError (L"Unable to find simple file system protocol (error: %r)\n", Status);
@@ -711,6 +1614,7 @@ UefiMain (
     PrintDebug (L"Found simple file system protocol\n");
   }
   Status = Volume->OpenVolume (Volume, &mVolumeRoot);
+  PhaseEnd (PhaseVolumeOpen);
   if (EFI_ERROR (Status)) {
     PrintError (L"Unable to open volume (error: %r)\n", Status);
     goto Exit;
@@ -722,10 +1626,39 @@ UefiMain (
     goto Exit;
   }
 
+  //
+  // Enumerate our own directory once, so that checks for the
+  // files next to us do not each need a trip to the disk.
+  //
+  PhaseBegin (PhaseDirectoryScan);
+  Status = ScanDirectory (mVolumeRoot, mEfiFilePath);
+  PhaseEnd (PhaseDirectoryScan);
+  if (EFI_ERROR (Status)) {
+    PrintDebug (L"Unable to scan directory of '%s' (error: %r)\n", mEfiFilePath, Status);
+  }
+
+  //
+  // Preferred UefiSeven.ini, instead of bootx64.ini / bootmgfw.ini.
+  //
+  // Check if <MyName>.ini exists
+  //Status = ChangeExtension (mEfiFilePath, L"ini", (VOID **)&ConfigFilePath);
+  // Check if UefiSeven.ini exists
+  Status = GetFilenameInSameDirectory (mEfiFilePath, L"UefiSeven.ini", (VOID **)&ConfigFilePath);
+  if (EFI_ERROR (Status)) {
+    ConfigFilePath = NULL;
+  }
+
+  //
+  // Pick up the decisions made during the previous boot, provided
+  // neither the display nor the config have changed since.
+  //
+  LoadBootCache (ConfigFilePath);
+
   //
   // Read <config>.ini, fallback to check existence of old UefiSeven.* files.
   //
-  if (!ReadConfig ()) {
+  PhaseBegin (PhaseReadConfig);
+  if (!ReadConfig (ConfigFilePath)) {
     //
     // Check if we should skip warnings and prompts
     //
@@ -753,28 +1686,47 @@ UefiMain (
       FreePool (VerboseFilePath);
     }
   }
+  PhaseEnd (PhaseReadConfig);
+
+  if (ConfigFilePath != NULL) {
+    FreePool (ConfigFilePath);
+  }
+
+  //
+  // A binary log has to start with its header, which BlogDecode.py
+  // looks for before anything else. Write it now, before the first
+  // message lands in the ring, even if neither the table nor the
+  // file can be set up in the end.
+  //
+  if (mLogToFile ? mBinaryLog : (mLogToTable && mBinaryTable)) {
+    LogAppendBinaryHeader ();
+  }
+
+  //
+  // The table shares the log file's ring, unless their formats differ.
+  //
+  if (mLogToTable) {
+    Status = LogTableInstall (mBinaryTable, mLogToFile && (mBinaryLog != mBinaryTable));
+    if (EFI_ERROR (Status)) {
+      mLogToTable = FALSE;
+      PrintDebug (L"Unable to publish log table (error: %r)\n", Status);
+    }
+  }
 
   if (mLogToFile) {
     mLogToFile = FALSE;
-    Status = GetFilenameInSameDirectory (mEfiFilePath, L"UefiSeven.log", (VOID **)&LogFilePath);
+    Status = GetFilenameInSameDirectory (
+               mEfiFilePath,
+               mBinaryLog ? L"UefiSeven.blog" : L"UefiSeven.log",
+               (VOID **)&LogFilePath);
     if (!EFI_ERROR (Status)) {
-	  PrintDebug (L"Clearing previous log file\n");
-      FileDelete (mVolumeRoot, LogFilePath);
-
-      Status = mVolumeRoot->Open (
-                              mVolumeRoot,
-                              &mLogFileHandle,
-                              LogFilePath,
-                              EFI_FILE_MODE_READ | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_CREATE,
-                              0);
+      // Re-enable mLogToFile if the log file could be opened.
+      Status = LogOpen (mVolumeRoot, LogFilePath);
       if (!EFI_ERROR (Status)) {
-        FileInfo = GetFileInfo (mLogFileHandle);
-        if (FileInfo != NULL) {
-          // Re-enable mLogToFile if its not directory.
-          if ((FileInfo->Attribute & EFI_FILE_DIRECTORY) == 0) {
-            mLogToFile = TRUE;
-          }
-        }
+        mLogToFile = TRUE;
+        PrintDebug (L"Logging boot %u to '%s'\n", LogBootSequence (), LogFilePath);
+      } else {
+        PrintDebug (L"Unable to open log file '%s' (error: %r)\n", LogFilePath, Status);
       }
       FreePool (LogFilePath);
     }
@@ -790,7 +1742,15 @@ UefiMain (
     }
   }
 
+  //
+  // Verbose mode would not show anything if debug messages are filtered out.
+  //
+  if (mLogLevel < LOG_LEVEL_DEBUG) {
+    mVerboseMode = FALSE;
+  }
+
   PrintDebug (L"UefiSeven %s\n", VERSION);
+  PrintDebug (L"Boot cache %s\n", mBootCacheLoaded ? L"valid, using known-good path" : L"not used");
 
   if (mVerboseMode) {
     PrintDebug (L"You are running in verbose mode, press Enter to continue\n");
@@ -805,15 +1765,45 @@ UefiMain (
   //}
 
   //
-  // Windows 7 prefers a 1024x768 resolution.
+  // Windows 7 needs at least 1024x768, the shim centers its screen
+  // within larger modes. With native_resolution the display is left
+  // at its native resolution, which the shim offers as another mode.
   //
-  SwitchVideoMode (1024, 768);
-  if (mVerboseMode || mLogToFile) {
+  // No need to rate all modes again if none was usable last time.
+  if (!(mBootCacheLoaded && mBootCache.ScanlineHack && (mBootCache.GopMode == BOOT_CACHE_NO_MODE))) {
+    PhaseBegin (PhaseSwitchVideoMode);
+    if (mNativeResolution
+      && NativeResolution (&NativeWidth, &NativeHeight)
+      && (NativeWidth >= 1024) && (NativeHeight >= 768)
+      )
+    {
+      SwitchVideoMode (NativeWidth, NativeHeight, mBootCache.GopMode);
+    } else {
+      SwitchVideoMode (1024, 768, mBootCache.GopMode);
+    }
+    PhaseEnd (PhaseSwitchVideoMode);
+  }
+  if ((mVerboseMode || mLogToFile || mLogToTable) && (mLogLevel >= LOG_LEVEL_DEBUG)) {
     PrintVideoInfo ();
   }
 
-  if (!MatchCurrentResolution (1024, 768)) {
-    PrintError (L"Current display does not seem to support changing to 1024x768 resolution\n");
+  mBootCache.ScanlineHack = !CurrentResolutionFits (1024, 768);
+  if (!mBootCache.ScanlineHack && (mDisplayInfo.Protocol == GOP)) {
+    mBootCache.GopMode = mDisplayInfo.GOP->Mode->Mode;
+  } else {
+    mBootCache.GopMode = BOOT_CACHE_NO_MODE;
+  }
+
+  //
+  // Let the Windows VGA driver draw into a write-combining framebuffer.
+  // Not with the scanline hack, whose framebuffer size is made up.
+  //
+  if (mFbWriteCombine && !mBootCache.ScanlineHack) {
+    SetFrameBufferWriteCombining ();
+  }
+
+  if (mBootCache.ScanlineHack) {
+    PrintError (L"Current display does not seem to support a resolution of 1024x768 or larger\n");
     PrintError (L"which is the minimum requirement of Windows 7.\n");
     PrintError (L"It is likely that Windows might fail to boot even with the handler installed.\n");
     PrintError (L"Press Enter to try a new 'hack' that will force the display driver to work.\n");
@@ -821,7 +1811,9 @@ UefiMain (
     if (!mSkipErrors) {
       WaitForEnter (FALSE);
     }
+    PhaseBegin (PhaseForceVideoModeHack);
     ForceVideoModeHack (1024, 768);
+    PhaseEnd (PhaseForceVideoModeHack);
   }
 
   //
@@ -831,6 +1823,7 @@ UefiMain (
   if (!mForceFakeVesa) {
     if (IsInt10hHandlerDefined ()) {
       PrintDebug (L"Int10h already has a handler, no further action required\n");
+      InstallStatus = EFI_SUCCESS;
       goto Exit;
     }
   } else {
@@ -840,45 +1833,96 @@ UefiMain (
   //
   // Sanity checks.
   //
-  if (sizeof (INT10H_HANDLER) > VGA_ROM_SIZE) {
+  Handler = SelectedInt10hHandler (&HandlerSize);
+  if (HandlerSize > VGA_ROM_SIZE) {
     PrintError (L"Shim size bigger than allowed (%u > %u), aborting\n",
-      sizeof (INT10H_HANDLER), VGA_ROM_SIZE);
+      HandlerSize, VGA_ROM_SIZE);
     goto Exit;
   }
+  if (mHandlerTrace) {
+    PrintDebug (L"Using the instrumented Int10h handler\n");
+  }
 
   //
-  // Unlock VGA ROM memory area for writing first.
+  // Build the shim in a buffer first and fill in the missing
+  // information. It may well be in place already, e.g. when
+  // UefiSeven is started twice in one boot.
   //
-  Status = EnsureMemoryLock (VGA_ROM_ADDRESS, (UINT32)VGA_ROM_SIZE, UNLOCK);
-  if (EFI_ERROR (Status)) {
-    PrintError (L"Unable to unlock VGA ROM memory at %04x, aborting\n", VGA_ROM_ADDRESS);
+  ShimImage = AllocateZeroPool (VGA_ROM_SIZE);
+  if (ShimImage == NULL) {
+    PrintError (L"Unable to allocate shim image, aborting\n");
     goto Exit;
   }
+  CopyMem (ShimImage, Handler, HandlerSize);
 
   //
-  // Copy ROM stub in place and fill in the missing information.
+  // Unless the VGA ROM is kept writable for the trace, the current
+  // mode has to be kept elsewhere.
   //
-  ZeroMem ((VOID *)VGA_ROM_ADDRESS, VGA_ROM_SIZE);
-  CopyMem ((VOID *)VGA_ROM_ADDRESS, INT10H_HANDLER, sizeof (INT10H_HANDLER));
-  Status = ShimVesaInformation (VGA_ROM_ADDRESS, &Int10hHandlerAddress);
+  if (!mHandlerTrace && !mBootCache.LowMemoryShim) {
+    ReserveShimData ();
+  }
+
+  PhaseBegin (PhaseShimVesaInformation);
+  Status = ShimVesaInformation (ShimImage, VGA_ROM_ADDRESS, &ShimImageSize);
+  PhaseEnd (PhaseShimVesaInformation);
   if (EFI_ERROR (Status)) {
     PrintError (L"VESA information could not be filled in, aborting\n");
     goto Exit;
   } else {
     // Convert from 32bit physical address to real mode segment address.
     NewInt10hHandlerEntry.Segment = (UINT16)((UINT32)VGA_ROM_ADDRESS >> 4);
-    NewInt10hHandlerEntry.Offset  = (UINT16)(Int10hHandlerAddress - VGA_ROM_ADDRESS);
+    NewInt10hHandlerEntry.Offset  = (UINT16)SHIM_HANDLER_OFFSET;
     PrintDebug (L"VESA information filled in, Int10h handler address=%x (%04x:%04x)\n",
-      Int10hHandlerAddress, NewInt10hHandlerEntry.Segment, NewInt10hHandlerEntry.Offset);
+      VGA_ROM_ADDRESS + SHIM_HANDLER_OFFSET, NewInt10hHandlerEntry.Segment, NewInt10hHandlerEntry.Offset);
+  }
+
+  if (mBootCache.LowMemoryShim) {
+    PrintDebug (L"VGA ROM memory cannot be unlocked on this system, not trying again\n");
+    Status = EFI_UNSUPPORTED;
+  } else if (CompareMem ((VOID *)VGA_ROM_ADDRESS, ShimImage, VGA_ROM_SIZE) == 0) {
+    PrintDebug (L"VGA ROM memory already holds the shim, leaving it untouched\n");
+    Status = EFI_SUCCESS;
+  } else {
+    Status = WriteShimImage (ShimImage, mHandlerTrace);
   }
 
   //
-  // Lock VGA ROM memory area to prevent further writes.
+  // Without a writable VGA ROM, put the shim below 640 KiB instead.
+  // That sticks only if there is no way to unlock it at all, an
+  // approach that failed this time may well work on the next boot.
   //
-  Status = EnsureMemoryLock (VGA_ROM_ADDRESS, (UINT32)VGA_ROM_SIZE, LOCK);
+  mBootCache.LowMemoryShim = (Status == EFI_UNSUPPORTED);
   if (EFI_ERROR (Status)) {
-    PrintDebug (L"Unable to lock VGA ROM memory at %x but this is not essential\n",
-      VGA_ROM_ADDRESS);
+    // Low memory is writable, the shim keeps its fields itself.
+    if (mShimDataAllocated) {
+      gBS->FreePages (mShimDataAddress, 1);
+    }
+    mShimDataAddress    = 0;
+    mShimDataAllocated  = FALSE;
+    Status = PlaceShimInLowMemory (ShimImage, ShimImageSize, &NewInt10hHandlerEntry);
+    if (EFI_ERROR (Status)) {
+      PrintError (L"Unable to place the shim in low memory either, aborting\n");
+      goto Exit;
+    }
+  }
+
+  //
+  // Only the instrumented handler prints to the serial port. Program
+  // the UART once, now that the shim is in place, so that it does not
+  // have to on every call.
+  //
+  Header = (SHIM_HEADER *)(ShimImage + SHIM_HEADER_OFFSET);
+  if (Header->SerialReady) {
+    InitializeHandlerSerial (Header->SerialPort, Header->SerialDivisor);
+  }
+
+  //
+  // The handler finds the writable fields at the same offsets
+  // in the data page as in the shim.
+  //
+  if (mShimDataAddress != 0) {
+    CopyMem ((VOID *)(UINTN)(mShimDataAddress + SHIM_HEADER_OFFSET), Header, sizeof (SHIM_HEADER));
   }
 
   //
@@ -911,7 +1955,9 @@ UefiMain (
   //
   if (IsInt10hHandlerDefined ()) {
     PrintDebug (L"Pre-boot Int10h sanity check success\n");
+    InstallStatus = EFI_SUCCESS;
   } else {
+    InstallStatus = EFI_NOT_FOUND;
     PrintError (L"Pre-boot Int10h sanity check failed\n");
     PrintError (L"Press Enter to continue.\n");
     if (!mSkipErrors) {
@@ -921,6 +1967,20 @@ UefiMain (
 
   Exit:
 
+  if (ShimImage != NULL) {
+    FreePool (ShimImage);
+  }
+
+  SaveBootCache ();
+  LogTableSetResult (InstallStatus);
+
+  //
+  // Bring all processors in line with the MTRR changes made above.
+  //
+  PhaseBegin (PhaseMtrrUpdate);
+  MtrrCommit (TRUE);
+  PhaseEnd (PhaseMtrrUpdate);
+
   //
   // Check if we can chainload the Windows Boot Manager.
   //
@@ -963,12 +2023,17 @@ UefiMain (
     FreePool (mEfiFilePath);
   }
 
+  FreeDirectoryCache ();
+
   if (mLogToFile) {
     if (mLogFileHandle != NULL) {
+      LogFlush ();
       mLogFileHandle->Close (mLogFileHandle);
     }
   }
 
+  LogFree ();
+
   if (mVolumeRoot != NULL) {
     mVolumeRoot->Close (mVolumeRoot);
   }
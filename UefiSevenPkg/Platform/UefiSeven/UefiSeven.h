@@ -17,6 +17,18 @@
 #define __UEFI_SEVEN_H
 
 
+/**
+  -----------------------------------------------------------------------------
+  Constants.
+  -----------------------------------------------------------------------------
+**/
+
+// Size arrays, the rest of the constants are STATIC CONST at the bottom.
+#define SHIM_MAX_MODES          15    // 0F1h-0FFh, 100h is standard VESA 640x400x8
+#define SHIM_VBE_FUNCTIONS      0x16  // entries of the handler dispatch tables
+#define SHIM_LEGACY_FUNCTIONS   0x20
+
+
 /**
   -----------------------------------------------------------------------------
   Includes.
@@ -29,14 +41,18 @@
 
 #include <IndustryStandard/LegacyVgaBios.h>
 
+#include <Protocol/Cpu.h>
 #include <Protocol/LegacyRegion.h>
 #include <Protocol/LegacyRegion2.h>
 #include <Protocol/LoadedImage.h>
+#include <Protocol/MemoryAttribute.h>
 #include <Protocol/SimpleTextInEx.h>
 
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/DxeServicesTableLib.h>
 #include <Library/IniParsingLib.h>
+#include <Library/IoLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/MtrrLib.h>
 #include <Library/PrintLib.h>
@@ -58,11 +74,74 @@ typedef struct {
 } IVT_ENTRY;
 #pragma pack()
 
+//
+// Shared with Int10hHandler.asm, which has its own copy of the field
+// offsets. Lives right after the VBE controller information; the
+// mode table, one VBE_MODE_INFO per mode, follows the handler code,
+// then the EDID of the display and the trace ring.
+// The handler reads and writes CurrentMode and the hit counters at the
+// same offsets within DataSegment, a page below 640 KiB when the shim
+// is in a locked VGA ROM.
+//
+#pragma pack(1)
+typedef struct {
+  UINT32  Signature;
+  UINT16  ModeCount;
+  UINT16  ModeTableOffset;        // from the start of the shim
+  UINT16  CurrentMode;            // as returned by function 4F03h, at DataSegment
+  UINT16  VbeHits[SHIM_VBE_FUNCTIONS];        // calls of 4F00h and up
+  UINT16  LegacyHits[SHIM_LEGACY_FUNCTIONS];  // calls of AH = 00h and up
+  UINT16  OtherHits;              // calls without a dispatch table entry
+  UINT16  TraceOffset;            // SHIM_TRACE_ENTRY ring, instrumented handler only
+  UINT16  TraceEntries;
+  UINT16  TraceHead;              // entry the next call goes to
+  UINT16  TraceSlot;              // entry of the call in progress
+  UINT32  TraceCalls;             // calls since boot, including overwritten ones
+  UINT16  SerialPort;             // UART the instrumented handler prints to, or 0
+  UINT16  SerialDivisor;          // UART_BASE_BAUD / baud rate
+  UINT8   SerialReady;            // UART programmed, by UefiSeven or the handler
+  UINT16  EdidOffset;             // EDID blocks for function 4F15h
+  UINT16  EdidBlocks;             // 0 without EDID
+  UINT16  DataSegment;            // where the handler writes CurrentMode and the hits
+} SHIM_HEADER;
+
+//
+// Registers of one Int10h call, written by the instrumented handler
+// (INT10H_HANDLER_TRACE). Decoded by ShimDecode.py.
+//
+typedef struct {
+  UINT16  Ax;
+  UINT16  Bx;
+  UINT16  Cx;
+  UINT16  Dx;
+  UINT16  AxOut;
+  UINT16  BxOut;
+  UINT16  CxOut;
+  UINT16  DxOut;
+} SHIM_TRACE_ENTRY;
+#pragma pack()
+
 typedef enum {
   LOCK,
   UNLOCK
 } MEMORY_LOCK_OPERATION;
 
+typedef enum {
+  LockMethodNone,             // memory was already in the desired state
+  LockMethodLegacyRegion,
+  LockMethodLegacyRegion2,
+  LockMethodMemoryAttribute,  // page table read-only bit, no cacheability change
+  LockMethodCpuArch,
+  LockMethodMtrr,
+  LockMethodMax
+} MEMORY_LOCK_METHOD;
+
+typedef struct {
+  MEMORY_LOCK_METHOD  Method;           // LockMethodNone until one has worked
+  UINT32              Granularity;      // as reported by Method, 0 if unknown
+  UINT32              FailedMethods;    // bit per MEMORY_LOCK_METHOD
+} MEMORY_LOCK_STRATEGY;
+
 
 /**
   -----------------------------------------------------------------------------
@@ -75,16 +154,38 @@ ShowAnimatedLogo (
   VOID
   );
 
+VOID
+LocateMemoryLockProtocols (
+  VOID
+  );
+
 BOOLEAN
 CanWriteAtAddress (
   IN  EFI_PHYSICAL_ADDRESS    Address
   );
 
 EFI_STATUS
-EnsureMemoryLock (
-  IN  EFI_PHYSICAL_ADDRESS    Address,
+ApplyMemoryLockMethod (
+  IN  MEMORY_LOCK_METHOD      Method,
+  IN  EFI_PHYSICAL_ADDRESS    StartAddress,
   IN  UINT32                  Length,
-  IN  MEMORY_LOCK_OPERATION   Operation
+  IN  MEMORY_LOCK_OPERATION   Operation,
+  OUT UINT32                  *Granularity
+  );
+
+EFI_STATUS
+EnsureMemoryLock (
+  IN      EFI_PHYSICAL_ADDRESS    Address,
+  IN      UINT32                  Length,
+  IN      MEMORY_LOCK_OPERATION   Operation,
+  IN OUT  MEMORY_LOCK_METHOD      *Method
+  );
+
+BOOLEAN
+IsShimHandler (
+  IN  IVT_ENTRY               *Entry,
+  IN  CONST UINT8             *Handler,
+  IN  UINTN                   HandlerSize
   );
 
 BOOLEAN
@@ -92,10 +193,69 @@ IsInt10hHandlerDefined (
   VOID
   );
 
+EFI_STATUS
+FillVbeModeInfo (
+  OUT VBE_MODE_INFO           *VbeModeInfo,
+  IN  UINT32                  Width,
+  IN  UINT32                  Height
+  );
+
+UINTN
+AddShimMode (
+  IN OUT  UINT32              *Widths,
+  IN OUT  UINT32              *Heights,
+  IN      UINTN               Count,
+  IN      UINT32              Width,
+  IN      UINT32              Height
+  );
+
+UINTN
+CollectShimModes (
+  OUT UINT32                  *Widths,
+  OUT UINT32                  *Heights
+  );
+
+CONST UINT8 *
+SelectedInt10hHandler (
+  OUT UINTN                   *Size
+  );
+
+VOID
+InitializeHandlerSerial (
+  IN  UINT16                  Port,
+  IN  UINT16                  Divisor
+  );
+
 EFI_STATUS
 ShimVesaInformation (
-  IN  EFI_PHYSICAL_ADDRESS    StartAddress,
-  OUT EFI_PHYSICAL_ADDRESS    *EndAddress
+  IN  UINT8                   *Image,
+  IN  EFI_PHYSICAL_ADDRESS    RomAddress,
+  OUT UINTN                   *ImageSize
+  );
+
+UINTN
+CopyChangedMem (
+  IN  UINT8                   *Destination,
+  IN  CONST UINT8             *Source,
+  IN  UINTN                   Length
+  );
+
+EFI_STATUS
+WriteShimImage (
+  IN  CONST UINT8             *Image,
+  IN  BOOLEAN                 KeepWritable
+  );
+
+EFI_STATUS
+ReserveShimData (
+  VOID
+  );
+
+EFI_STATUS
+PlaceShimInLowMemory (
+  IN OUT  UINT8               *Image,
+  IN      UINTN               ImageSize,
+  OUT     IVT_ENTRY           *Entry
   );
 
 VOID
@@ -119,8 +279,18 @@ STATIC CONST  CHAR8                 PRODUCT_NAME[]      = "Emulated VGA";
 STATIC CONST  CHAR8                 PRODUCT_REVISION[]  = "OVMF Int10h (fake)";
 STATIC CONST  EFI_PHYSICAL_ADDRESS  VGA_ROM_ADDRESS     = 0xC0000;
 STATIC CONST  EFI_PHYSICAL_ADDRESS  IVT_ADDRESS         = 0x00000;
+STATIC CONST  EFI_PHYSICAL_ADDRESS  LOW_MEMORY_LIMIT    = 0xA0000;
 STATIC CONST  UINTN                 VGA_ROM_SIZE        = 0x10000;
 STATIC CONST  UINTN                 FIXED_MTRR_SIZE     = 0x20000;
+STATIC CONST  UINTN                 SHIM_DIFF_MERGE     = 16;
+STATIC CONST  UINT32                SHIM_SIGNATURE      = SIGNATURE_32 ('U', '7', 'S', 'H');
+STATIC CONST  UINTN                 SHIM_HEADER_OFFSET  = 0x100;
+STATIC CONST  UINTN                 SHIM_HANDLER_OFFSET = 0x200;
+STATIC CONST  UINT16                SHIM_FIRST_MODE     = 0x00F1;
+STATIC CONST  UINTN                 SHIM_TRACE_ENTRIES  = 1024;
+STATIC CONST  UINTN                 SHIM_EDID_BLOCKS    = 4;      // base block and extensions
+STATIC CONST  UINT32                HANDLER_SERIAL_BAUD = 115200;
+STATIC CONST  UINT32                UART_BASE_BAUD      = 115200;
 
 
 #endif
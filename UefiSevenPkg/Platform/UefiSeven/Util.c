@@ -30,3 +30,48 @@ StrToLowercase (
     }
   }
 }
+
+
+/**
+  Compares up to Length characters of two strings, ignoring
+  the case of ASCII letters as FAT file names do.
+
+  @param[in] FirstString    First string to compare.
+  @param[in] SecondString   Second string to compare.
+  @param[in] Length         Maximum number of characters to compare.
+
+  @retval 0                 Both strings are equal.
+  @retval other             The difference between the first
+                            mismatched characters (lowercased).
+
+**/
+INTN
+StrnCmpNoCase (
+  IN  CONST CHAR16  *FirstString,
+  IN  CONST CHAR16  *SecondString,
+  IN  UINTN         Length
+  )
+{
+  CHAR16  First;
+  CHAR16  Second;
+
+  if ((FirstString == NULL) || (SecondString == NULL)) {
+    return (FirstString == SecondString) ? 0 : 1;
+  }
+
+  for (; Length > 0; Length--, FirstString++, SecondString++) {
+    First  = *FirstString;
+    Second = *SecondString;
+    if ((First >= L'A') && (First <= L'Z')) {
+      First = (CHAR16)(First - L'A' + L'a');
+    }
+    if ((Second >= L'A') && (Second <= L'Z')) {
+      Second = (CHAR16)(Second - L'A' + L'a');
+    }
+    if ((First != Second) || (First == L'\0')) {
+      return (INTN)First - (INTN)Second;
+    }
+  }
+
+  return 0;
+}
@@ -25,6 +25,18 @@
 
 #define DEBUG_MESSAGE_LENGTH  1024
 
+#define LOG_LEVEL_NONE        0
+#define LOG_LEVEL_ERROR       1
+#define LOG_LEVEL_DEBUG       2
+
+//
+// Messages above this level are compiled out, see
+// UEFISEVENPKG_LOG_LEVEL in UefiSevenPkg.dsc.
+//
+#ifndef UEFISEVEN_LOG_LEVEL
+#define UEFISEVEN_LOG_LEVEL   LOG_LEVEL_DEBUG
+#endif
+
 
 
 /**
@@ -47,6 +59,13 @@ StrToLowercase (
   IN  CHAR16  *String
   );
 
+INTN
+StrnCmpNoCase (
+  IN  CONST CHAR16  *FirstString,
+  IN  CONST CHAR16  *SecondString,
+  IN  UINTN         Length
+  );
+
 VOID
 EFIAPI
 PrintFuncNameMessage (
@@ -56,11 +75,25 @@ PrintFuncNameMessage (
   ...
   );
 
+//
+// Disabled messages stay type checked, but the call, its format
+// string and its arguments are dropped by the compiler.
+//
+#if UEFISEVEN_LOG_LEVEL >= LOG_LEVEL_DEBUG
 #define PrintDebug(Format, ...) \
   PrintFuncNameMessage (FALSE, __FUNCTION__, Format, ##__VA_ARGS__)
+#else
+#define PrintDebug(Format, ...) \
+  do { if (FALSE) { PrintFuncNameMessage (FALSE, __FUNCTION__, Format, ##__VA_ARGS__); } } while (FALSE)
+#endif
 
+#if UEFISEVEN_LOG_LEVEL >= LOG_LEVEL_ERROR
 #define PrintError(Format, ...) \
   PrintFuncNameMessage (TRUE, __FUNCTION__, Format, ##__VA_ARGS__)
+#else
+#define PrintError(Format, ...) \
+  do { if (FALSE) { PrintFuncNameMessage (TRUE, __FUNCTION__, Format, ##__VA_ARGS__); } } while (FALSE)
+#endif
 
 
 #endif